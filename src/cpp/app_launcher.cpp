@@ -0,0 +1,178 @@
+#include "app_launcher.hpp"
+#include "command_blacklist.hpp"
+#include <gdkmm/display.h>
+#include <gdkmm/applaunchcontext.h>
+#include <iostream>
+#include <map>
+#include <vector>
+
+// Activation may have to start the service first
+static const int ACTIVATE_TIMEOUT_MS = 10000;
+
+static std::string strip_suffix(const std::string& desktop_id) {
+    const std::string suffix = ".desktop";
+    if (desktop_id.size() > suffix.size() &&
+        desktop_id.compare(desktop_id.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        return desktop_id.substr(0, desktop_id.size() - suffix.size());
+    }
+    return desktop_id;
+}
+
+std::string AppLauncher::bus_name_for(const std::string& desktop_id) {
+    return strip_suffix(desktop_id);
+}
+
+std::string AppLauncher::object_path_for(const std::string& desktop_id) {
+    // org.gnome.Nautilus -> /org/gnome/Nautilus; '-' is not allowed in paths
+    std::string path = "/" + strip_suffix(desktop_id);
+    for (char& c : path) {
+        if (c == '.') {
+            c = '/';
+        } else if (c == '-') {
+            c = '_';
+        }
+    }
+    return path;
+}
+
+// Startup notification for a launch (null without a display)
+static Glib::RefPtr<Gio::AppLaunchContext> launch_context() {
+    auto display = Gdk::Display::get_default();
+    if (!display) {
+        return {};
+    }
+    return display->get_app_launch_context();
+}
+
+Glib::RefPtr<Gio::DBus::Connection> AppLauncher::session_bus() {
+    if (!bus_ && !bus_failed_) {
+        try {
+            bus_ = Gio::DBus::Connection::get_sync(Gio::DBus::BusType::SESSION);
+        } catch (const Glib::Error& e) {
+            std::cerr << "Launcher: No session bus, spawning instead: " << e.what() << "\n";
+            bus_failed_ = true;
+        }
+    }
+    return bus_;
+}
+
+std::string AppLauncher::exec_refusal(const Glib::RefPtr<Gio::DesktopAppInfo>& app) {
+    // GIO splits Exec lines itself and never hands them to a shell, so only
+    // the program is checked, not the shell patterns a command item could use
+    std::string exec = app->get_commandline();
+    auto& blacklist = CommandBlacklist::instance();
+    if (blacklist.is_blacklisted(exec)) {
+        return blacklist.get_blacklisted_info(exec);
+    }
+    return "";
+}
+
+std::string AppLauncher::exec_refusal(const std::string& desktop_id) {
+    auto app = Gio::DesktopAppInfo::create(strip_suffix(desktop_id) + ".desktop");
+    return app ? exec_refusal(app) : "";
+}
+
+bool AppLauncher::launch(const std::string& desktop_id, const std::string& fallback_command) {
+    std::string file_id = strip_suffix(desktop_id) + ".desktop";
+    auto app = Gio::DesktopAppInfo::create(file_id);
+    if (!app) {
+        std::cerr << "Launcher: No application " << file_id << "\n";
+        return !fallback_command.empty() && spawn(app, fallback_command, {});
+    }
+
+    // SECURITY: The Exec line follows the same policy as item commands. The
+    // whole launch is refused, since a failed activation would fall back to it
+    // (a fallback command was already checked as the item's command)
+    if (fallback_command.empty()) {
+        std::string refusal = exec_refusal(app);
+        if (!refusal.empty()) {
+            std::cerr << "SECURITY ERROR: " << refusal << "\n";
+            std::cerr << "  Application: " << file_id << "\n";
+            return false;
+        }
+    }
+
+    if (app->get_boolean("DBusActivatable") && session_bus()) {
+        activate(tasks_.token(), app, desktop_id, fallback_command);
+        return true;
+    }
+    return spawn(app, fallback_command, launch_context());
+}
+
+Task AppLauncher::activate(CancelToken token, Glib::RefPtr<Gio::DesktopAppInfo> app,
+                           std::string desktop_id, std::string fallback_command) {
+    // In a one-shot run the application would quit before the reply (and any
+    // fallback) arrives; it stays up until this coroutine ends
+    struct Held {
+        Glib::RefPtr<Gio::Application> app;
+
+        ~Held() {
+            if (app) {
+                app->release();
+            }
+        }
+    } held{Gio::Application::get_default()};
+    if (held.app) {
+        held.app->hold();
+    }
+
+    // Startup token so the window manager lets the app take focus
+    std::map<Glib::ustring, Glib::VariantBase> platform_data;
+    auto context = launch_context();
+    std::string startup_id;
+    if (context) {
+        startup_id = context->get_startup_notify_id(app, std::vector<Glib::RefPtr<Gio::File>>());
+        if (!startup_id.empty()) {
+            platform_data["desktop-startup-id"] = Glib::Variant<Glib::ustring>::create(startup_id);
+            platform_data["activation-token"] = Glib::Variant<Glib::ustring>::create(startup_id);
+        }
+    }
+
+    DBusCallAwaiter::Call call;
+    call.connection = bus_;
+    call.bus_name = bus_name_for(desktop_id);
+    call.object_path = object_path_for(desktop_id);
+    call.interface_name = "org.freedesktop.Application";
+    call.method_name = "Activate";
+    call.parameters = Glib::VariantContainerBase::create_tuple(
+        Glib::Variant<std::map<Glib::ustring, Glib::VariantBase>>::create(platform_data));
+    call.timeout_ms = ACTIVATE_TIMEOUT_MS;
+
+    DBusReply reply = co_await dbus_call(token, std::move(call));
+    if (!reply.ok) {
+        std::cerr << "Launcher: Activating " << desktop_id << " failed, spawning instead: "
+                  << reply.error << "\n";
+
+        // The activation's startup sequence ends here; a spawned app gets its own
+        if (!startup_id.empty()) {
+            context->launch_failed(startup_id);
+        }
+        spawn(app, fallback_command, context);
+    }
+}
+
+bool AppLauncher::spawn(const Glib::RefPtr<Gio::DesktopAppInfo>& app, const std::string& fallback_command,
+                        const Glib::RefPtr<Gio::AppLaunchContext>& context) {
+    try {
+        if (!fallback_command.empty()) {
+            Glib::spawn_command_line_async(fallback_command);
+            return true;
+        }
+        if (app && app->get_boolean("DBusActivatable")) {
+            // GIO would activate such an app over D-Bus again: run its Exec line directly
+            auto exec = Gio::AppInfo::create_from_commandline(
+                app->get_commandline(), app->get_name(),
+                Gio::AppInfo::CreateFlags::SUPPORTS_STARTUP_NOTIFICATION);
+            exec->launch(std::vector<Glib::RefPtr<Gio::File>>(), context);
+            return true;
+        }
+        if (app) {
+            app->launch(std::vector<Glib::RefPtr<Gio::File>>(), context);
+            return true;
+        }
+    } catch (const Glib::Error& e) {
+        std::cerr << "Launcher: Failed to start " << (fallback_command.empty() ? app->get_id() : fallback_command)
+                  << ": " << e.what() << "\n";
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <giomm.h>
+#include "main_loop_task.hpp"
+
+// Starts applications by .desktop ID
+// Apps declaring DBusActivatable=true are asked to open through
+// org.freedesktop.Application.Activate on the session bus, which reaches an
+// already-running instance without forking a process that would only hand
+// off to it. Everything else (and any failed activation) is spawned
+class AppLauncher {
+public:
+    static AppLauncher& instance() {
+        static AppLauncher inst;
+        return inst;
+    }
+
+    // Prevent copying
+    AppLauncher(const AppLauncher&) = delete;
+    AppLauncher& operator=(const AppLauncher&) = delete;
+
+    // GTK thread. desktop_id: e.g. "org.gnome.Nautilus" (".desktop" optional)
+    // fallback_command: spawned instead of the app's Exec line when not empty
+    // Returns false if nothing could be started right away; activation errors
+    // are only known later and fall back on their own
+    bool launch(const std::string& desktop_id, const std::string& fallback_command);
+
+    // Bus name and object path of an app ID, per the Desktop Entry spec
+    static std::string bus_name_for(const std::string& desktop_id);
+    static std::string object_path_for(const std::string& desktop_id);
+
+    // Why the command blacklist refuses the app's Exec line (empty if it does not)
+    static std::string exec_refusal(const Glib::RefPtr<Gio::DesktopAppInfo>& app);
+
+    // Same by .desktop ID (empty for unknown IDs, which start nothing anyway)
+    static std::string exec_refusal(const std::string& desktop_id);
+
+private:
+    AppLauncher() = default;
+
+    // Session bus, connected on first use and kept (null if unavailable)
+    Glib::RefPtr<Gio::DBus::Connection> session_bus();
+
+    Task activate(CancelToken token, Glib::RefPtr<Gio::DesktopAppInfo> app,
+                  std::string desktop_id, std::string fallback_command);
+    static bool spawn(const Glib::RefPtr<Gio::DesktopAppInfo>& app, const std::string& fallback_command,
+                      const Glib::RefPtr<Gio::AppLaunchContext>& context);
+
+    Glib::RefPtr<Gio::DBus::Connection> bus_;
+    bool bus_failed_ = false;
+
+    // Activations in flight (process lifetime)
+    CancelScope tasks_;
+};
@@ -0,0 +1,146 @@
+// Frame time of the button renderers, per kind of level
+// Each level type runs its own draw_buttons instantiation; every one is timed
+// while opening (wipe clip), open and closing, with both wedge renderers.
+// The baseline is the instantiation with every level feature on, which draws
+// any level with the checks made at run time, as before specialization.
+// Needs a display (run under xvfb-run); prints microseconds per frame
+
+#include "radial_menu.hpp"
+#include <gtkmm.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Frames drawn per measurement (after one warm-up frame)
+static const int FRAMES = 200;
+
+// Buttons per level
+static const int ITEMS = 8;
+
+// Reaches the drawing state of a menu (a friend of RadialMenu)
+class RadialMenuBench {
+public:
+    static void set_phase(RadialMenu& menu, double progress, bool closing) {
+        menu.animation_progress_ = progress;
+        menu.is_closing_ = closing;
+    }
+
+    static void draw(RadialMenu& menu, const Cairo::RefPtr<Cairo::Context>& cr, int width, int height) {
+        menu.on_draw(cr, width, height);
+    }
+
+    // The renderer select_renderer() picks for the level's features
+    static void use_specialized(RadialMenu& menu) {
+        menu.select_renderer();
+    }
+
+    // Every level feature on, whatever the level uses (the wedge renderer stays)
+    static void use_generic(RadialMenu& menu) {
+        unsigned features = RadialMenu::RENDER_ICONS | RadialMenu::RENDER_HINTS |
+                            RadialMenu::RENDER_OVERRIDES | RadialMenu::RENDER_PRIORITY;
+        if (menu.config_.renderer == Renderer::Analytic) {
+            features |= RadialMenu::RENDER_ANALYTIC;
+        }
+        menu.draw_buttons_ = RadialMenu::renderer_for(features);
+        menu.draw_buttons_wipe_ = RadialMenu::renderer_for(features | RadialMenu::RENDER_WIPE);
+    }
+};
+
+struct LevelType {
+    const char* name;
+    std::function<void(MenuItem& item, int index)> decorate;
+};
+
+struct Phase {
+    const char* name;
+    double progress;
+    bool closing;
+};
+
+static double time_frames(RadialMenu& menu, const Phase& phase, int size) {
+    auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, size, size);
+    auto cr = Cairo::Context::create(surface);
+    RadialMenuBench::set_phase(menu, phase.progress, phase.closing);
+    RadialMenuBench::draw(menu, cr, size, size);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        RadialMenuBench::draw(menu, cr, size, size);
+    }
+    surface->flush();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / FRAMES;
+}
+
+static void run() {
+    const std::vector<LevelType> levels = {
+        {"plain", [](MenuItem&, int) {}},
+        {"icons", [](MenuItem& item, int) { item.icon = "folder"; }},
+        {"hints", [](MenuItem& item, int index) { item.hotkey = std::to_string(index + 1); }},
+        {"overrides", [](MenuItem& item, int index) {
+            Theme theme;
+            theme.background_color = Color::from_rgb(40 * index % 255, 90, 160);
+            item.theme_override = theme;
+        }},
+        {"priority", [](MenuItem& item, int index) { item.priority = index % 4 == 0 ? 8 : 0; }},
+        {"all", [](MenuItem& item, int index) {
+            item.icon = "folder";
+            item.hotkey = std::to_string(index + 1);
+            item.theme_override = Theme();
+            item.priority = index % 4 == 0 ? 8 : 0;
+        }},
+    };
+    const std::vector<Phase> phases = {
+        {"opening", 0.5, false},
+        {"open", 1.0, false},
+        {"closing", 0.5, true},
+    };
+
+    std::printf("%-10s %-9s %-8s %12s %12s %8s\n", "level", "renderer", "phase", "specialized", "generic", "change");
+    for (const auto& level : levels) {
+        for (Renderer renderer : {Renderer::Cairo, Renderer::Analytic}) {
+            RadialConfig config;
+            config.renderer = renderer;
+            config.breadcrumbs = false;
+            for (int i = 0; i < ITEMS; ++i) {
+                MenuItem item("Item " + std::to_string(i + 1), "true");
+                level.decorate(item, i);
+                config.items.push_back(item);
+            }
+
+            RadialMenu menu(config);
+            int size = 2 * (config.radius + 40);
+
+            // Let queued icon loads finish before timing
+            auto settle = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+            while (std::chrono::steady_clock::now() < settle) {
+                g_main_context_iteration(nullptr, FALSE);
+            }
+
+            for (const auto& phase : phases) {
+                RadialMenuBench::use_specialized(menu);
+                double specialized = time_frames(menu, phase, size);
+                RadialMenuBench::use_generic(menu);
+                double generic = time_frames(menu, phase, size);
+                std::printf("%-10s %-9s %-8s %10.1fus %10.1fus %+7.1f%%\n", level.name,
+                            renderer == Renderer::Cairo ? "cairo" : "analytic", phase.name,
+                            specialized, generic, 100.0 * (specialized - generic) / generic);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    // Keep the bench away from the real usage data
+    char home[] = "/tmp/radux-bench-XXXXXX";
+    if (mkdtemp(home)) {
+        setenv("HOME", home, 1);
+    }
+
+    auto app = Gtk::Application::create("com.github.raduxmenu.bench", Gio::Application::Flags::NON_UNIQUE);
+    app->signal_activate().connect(run);
+    return app->run(argc, argv);
+}
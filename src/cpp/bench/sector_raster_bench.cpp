@@ -0,0 +1,74 @@
+// Cairo paths against the analytic rasterizer, per wedge shape
+// Each shape is filled and stroked into an ARGB32 surface the size of a
+// menu window; prints microseconds per wedge for both paths
+
+#include "sector_raster.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+static const int SIZE = 440;
+
+// Wedges drawn per measurement (after one warm-up wedge)
+static const int REPEATS = 500;
+
+static double time_wedges(const std::function<void(const Cairo::RefPtr<Cairo::Context>&)>& draw) {
+    auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, SIZE, SIZE);
+    auto cr = Cairo::Context::create(surface);
+    draw(cr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEATS; ++i) {
+        draw(cr);
+    }
+    surface->flush();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / REPEATS;
+}
+
+int main() {
+    Color fill = Color::from_rgb(34, 34, 34);
+    fill.a = 0.85;
+    Color border = Color::from_rgb(230, 230, 230);
+    border.a = 0.9;
+
+    struct Shape {
+        const char* name;
+        double inner, outer;
+        double span;
+    };
+    const Shape shapes[] = {
+        {"8 items", 40, 120, M_PI / 4},
+        {"4 items", 40, 120, M_PI / 2},
+        {"2 items", 40, 120, M_PI},
+        {"12 large", 60, 200, M_PI / 6},
+        {"ring", 40, 120, 2 * M_PI},
+        {"disc", 0, 40, 2 * M_PI},
+    };
+
+    std::printf("%-10s %10s %10s %8s\n", "shape", "cairo", "analytic", "speedup");
+    for (const auto& shape : shapes) {
+        double c = SIZE / 2.0;
+        double start = shape.span >= 2 * M_PI ? 0 : -M_PI / 2;
+        AnnularSector sector{c, c, shape.inner, shape.outer, start, start + shape.span};
+
+        double cairo = time_wedges([&](const Cairo::RefPtr<Cairo::Context>& cr) {
+            cr->begin_new_path();
+            cr->arc(c, c, sector.outer_radius, sector.start_angle, sector.end_angle);
+            cr->arc_negative(c, c, sector.inner_radius, sector.end_angle, sector.start_angle);
+            cr->close_path();
+            fill.set_as_source(cr);
+            cr->fill_preserve();
+            border.set_as_source(cr);
+            cr->set_line_width(2);
+            cr->stroke();
+        });
+        double analytic = time_wedges([&](const Cairo::RefPtr<Cairo::Context>& cr) {
+            paint_sector(cr, sector, fill, border, 2);
+        });
+
+        std::printf("%-10s %8.1fus %8.1fus %7.2fx\n", shape.name, cairo, analytic, cairo / analytic);
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include "browse_provider.hpp"
+#include "shell_Utilities.hpp"
+#include <glib-unix.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Bytes requested per getdents64 call (a few hundred entries)
+static const size_t DIRENT_BUFFER_SIZE = 32 * 1024;
+
+// inotify watches are a per-user kernel resource; beyond this, listings are not cached
+static const size_t MAX_WATCHES = 512;
+
+// Directory changes that make a cached listing stale
+static const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                   IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_ONESHOT;
+
+// Record layout returned by the getdents64 system call
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+static std::string join_path(const std::string& directory, const std::string& name) {
+    if (!directory.empty() && directory.back() == '/') {
+        return directory + name;
+    }
+    return directory + "/" + name;
+}
+
+static std::string lowercase(const std::string& str) {
+    std::string result = str;
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return result;
+}
+
+BrowseProvider::BrowseProvider(const std::string& opener, int limit, bool show_hidden)
+    : opener_(opener.empty() ? "xdg-open" : opener)
+    , limit_(static_cast<size_t>(std::max(limit, 1)))
+    , show_hidden_(show_hidden)
+{
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        std::cerr << "Browse: inotify unavailable, directory listings will not be cached\n";
+        return;
+    }
+
+    inotify_source_id_ = g_unix_fd_add(
+        inotify_fd_, G_IO_IN,
+        [](gint, GIOCondition, gpointer data) -> gboolean {
+            static_cast<BrowseProvider*>(data)->on_inotify_events();
+            return G_SOURCE_CONTINUE;
+        },
+        this
+    );
+}
+
+BrowseProvider::~BrowseProvider() {
+    if (inotify_source_id_ != 0) {
+        g_source_remove(inotify_source_id_);
+    }
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+}
+
+ProviderCachePolicy BrowseProvider::cache_policy() const {
+    ProviderCachePolicy policy;
+    policy.mode = inotify_fd_ >= 0 ? ProviderCacheMode::Session : ProviderCacheMode::None;
+    return policy;
+}
+
+void BrowseProvider::fetch(const std::string& arg, ProviderRequest& request) {
+    // Watch before reading so a change during the listing is not missed
+    if (!watch_directory(arg)) {
+        request.set_cacheable(false);
+    }
+
+    std::vector<Entry> entries;
+    if (!read_directory(arg, request, entries)) {
+        request.set_cacheable(false);
+        return;
+    }
+
+    // Directories first, then case-insensitive by name; only the shown prefix is sorted
+    size_t shown = std::min(entries.size(), limit_);
+    std::partial_sort(entries.begin(), entries.begin() + shown, entries.end(),
+                      [](const Entry& a, const Entry& b) {
+                          if (a.is_directory != b.is_directory) {
+                              return a.is_directory;
+                          }
+                          std::string la = lowercase(a.name);
+                          std::string lb = lowercase(b.name);
+                          return la != lb ? la < lb : a.name < b.name;
+                      });
+
+    // First item opens the directory itself
+    MenuItem open_item;
+    open_item.label = "Open";
+    open_item.action = [opener = opener_, arg]() { SafeExecutor::open_with(opener, arg); };
+    open_item.description = arg;
+    if (entries.size() > shown) {
+        open_item.description += "\n(" + std::to_string(entries.size() - shown) + " more not shown)";
+    }
+    if (!request.emit(std::move(open_item))) {
+        return;
+    }
+
+    for (size_t i = 0; i < shown; ++i) {
+        if (!request.emit(make_item(arg, entries[i]))) {
+            return;
+        }
+    }
+}
+
+bool BrowseProvider::read_directory(const std::string& path, ProviderRequest& request,
+                                    std::vector<Entry>& entries) const {
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Browse: Cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    alignas(LinuxDirent64) char buffer[DIRENT_BUFFER_SIZE];
+    bool ok = true;
+
+    while (!request.is_cancelled()) {
+        long bytes = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (bytes == 0) {
+            break;
+        }
+        if (bytes < 0) {
+            std::cerr << "Browse: Cannot read " << path << ": " << std::strerror(errno) << "\n";
+            ok = false;
+            break;
+        }
+
+        for (long pos = 0; pos < bytes;) {
+            auto* dirent = reinterpret_cast<LinuxDirent64*>(buffer + pos);
+            pos += dirent->d_reclen;
+
+            const char* name = dirent->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            if (name[0] == '.' && !show_hidden_) {
+                continue;
+            }
+
+            // Only symlinks and file systems without d_type cost an extra stat
+            bool is_directory = dirent->d_type == DT_DIR;
+            if (dirent->d_type == DT_UNKNOWN || dirent->d_type == DT_LNK) {
+                struct stat st;
+                is_directory = fstatat(fd, name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+            }
+
+            entries.push_back(Entry{name, is_directory});
+        }
+    }
+
+    close(fd);
+    return ok && !request.is_cancelled();
+}
+
+bool BrowseProvider::watch_directory(const std::string& path) {
+    if (inotify_fd_ < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(watch_mutex_);
+    if (watches_.size() >= MAX_WATCHES) {
+        return false;
+    }
+
+    int wd = inotify_add_watch(inotify_fd_, path.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        return false;
+    }
+
+    // The same directory may be reached under several spellings of its path
+    auto& args = watches_[wd];
+    if (std::find(args.begin(), args.end(), path) == args.end()) {
+        args.push_back(path);
+    }
+    return true;
+}
+
+MenuItem BrowseProvider::make_item(const std::string& directory, const Entry& entry) const {
+    std::string path = join_path(directory, entry.name);
+
+    MenuItem item;
+    item.label = entry.name;
+    item.description = path;
+    if (entry.is_directory) {
+        item.provider = "browse";
+        item.provider_arg = path;
+    } else {
+        // Spawned without a shell, so no name is mistaken for shell syntax
+        item.action = [opener = opener_, path]() { SafeExecutor::open_with(opener, path); };
+    }
+    return item;
+}
+
+void BrowseProvider::on_inotify_events() {
+    alignas(struct inotify_event) char buffer[4096];
+    auto& registry = ProviderRegistry::instance();
+
+    while (true) {
+        ssize_t bytes = read(inotify_fd_, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            break;
+        }
+
+        for (ssize_t pos = 0; pos < bytes;) {
+            auto* event = reinterpret_cast<struct inotify_event*>(buffer + pos);
+            pos += sizeof(struct inotify_event) + event->len;
+
+            std::vector<std::string> stale;
+            {
+                std::lock_guard<std::mutex> lock(watch_mutex_);
+                auto it = watches_.find(event->wd);
+                if (it == watches_.end()) {
+                    continue;
+                }
+                stale = it->second;
+
+                // One-shot watches are gone after their first event
+                if (event->mask & IN_IGNORED) {
+                    watches_.erase(it);
+                }
+            }
+
+            for (const auto& arg : stale) {
+                registry.invalidate("browse", arg);
+            }
+        }
+    }
+}
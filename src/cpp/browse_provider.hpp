@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <glib.h>
+#include "menu_provider.hpp"
+
+// Built-in "browse" provider: one submenu level per directory
+// Only the directory being entered is read (on a worker thread); listings stay
+// cached until inotify reports a change in that directory
+class BrowseProvider : public MenuProvider {
+public:
+    // opener: command that receives the file path (e.g. "xdg-open")
+    // limit: maximum entries shown per directory
+    BrowseProvider(const std::string& opener, int limit, bool show_hidden);
+    ~BrowseProvider() override;
+
+    // Prevent copying
+    BrowseProvider(const BrowseProvider&) = delete;
+    BrowseProvider& operator=(const BrowseProvider&) = delete;
+
+    ProviderCachePolicy cache_policy() const override;
+    void fetch(const std::string& arg, ProviderRequest& request) override;
+
+private:
+    struct Entry {
+        std::string name;
+        bool is_directory;
+    };
+
+    std::string opener_;
+    size_t limit_;
+    bool show_hidden_;
+
+    // Change notification (watches are added from workers, events read on the GTK thread)
+    int inotify_fd_ = -1;
+    guint inotify_source_id_ = 0;
+    std::mutex watch_mutex_;
+    std::unordered_map<int, std::vector<std::string>> watches_;  // Watch descriptor -> cache args
+
+    // Worker thread helpers
+    bool read_directory(const std::string& path, ProviderRequest& request,
+                        std::vector<Entry>& entries) const;
+    bool watch_directory(const std::string& path);
+    MenuItem make_item(const std::string& directory, const Entry& entry) const;
+
+    // GTK thread: drop cached listings of directories that changed
+    void on_inotify_events();
+};
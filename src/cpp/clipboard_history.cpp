@@ -0,0 +1,321 @@
+#include "clipboard_history.hpp"
+#include "text_Utilities.hpp"
+#include <gtk/gtk.h>
+#include <gdk/gdk.h>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+#if defined(HAS_X11) && defined(HAS_XFIXES) && defined(GDK_WINDOWING_X11)
+#define CLIPBOARD_X11 1
+#include <gdk/x11/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/Xfixes.h>
+#endif
+
+// Larger copies are skipped (and this keeps replies within one X request)
+static const size_t MAX_ENTRY_BYTES = 64 * 1024;
+
+// Characters of an entry shown as its label
+static const size_t LABEL_CHARS = 24;
+
+// Characters of an entry shown as its description
+static const size_t DESCRIPTION_CHARS = 200;
+
+// Menu label: first non-empty line, shortened on a UTF-8 boundary
+static std::string make_label(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "(blank)";
+    }
+    size_t end = text.find_first_of("\r\n", start);
+    std::string line = text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    return Utf8Text::truncate(line, LABEL_CHARS);
+}
+
+#ifdef CLIPBOARD_X11
+
+struct ClipboardX11 {
+    ClipboardHistory* history = nullptr;
+    GdkDisplay* gdk_display = nullptr;
+    Display* display = nullptr;
+    Window window = None;
+    gulong handler_id = 0;
+    int xfixes_event_base = 0;
+
+    Atom clipboard = None;
+    Atom utf8_string = None;
+    Atom targets = None;
+    Atom text = None;
+    Atom property = None;   // Where converted selections are delivered
+    Atom timestamp = None;  // Zero-length appends here yield a server time
+
+    std::string owned_text;  // Served while this window owns CLIPBOARD
+    Time owned_time = CurrentTime;
+
+    Time server_time();
+    void answer_request(const XSelectionRequestEvent& request);
+};
+
+// ICCCM forbids CurrentTime in selection calls: take the time of the user's
+// last event, or else of a PropertyNotify this window provokes itself
+Time ClipboardX11::server_time() {
+    Time time = gdk_x11_display_get_user_time(gdk_display);
+    if (time != CurrentTime) {
+        return time;
+    }
+
+    XChangeProperty(display, window, timestamp, XA_STRING, 8, PropModeAppend, nullptr, 0);
+    XEvent event;
+    XWindowEvent(display, window, PropertyChangeMask, &event);
+    return event.xproperty.time;
+}
+
+void ClipboardX11::answer_request(const XSelectionRequestEvent& request) {
+    XSelectionEvent reply = {};
+    reply.type = SelectionNotify;
+    reply.display = request.display;
+    reply.requestor = request.requestor;
+    reply.selection = request.selection;
+    reply.target = request.target;
+    reply.time = request.time;
+
+    // Requests from before we took the selection belong to the previous owner
+    bool stale = request.time != CurrentTime && request.time < owned_time;
+
+    // Obsolete clients leave the property unset and expect the target name
+    Atom property = request.property != None ? request.property : request.target;
+    reply.property = property;
+
+    if (stale) {
+        reply.property = None;
+    } else if (request.target == targets) {
+        Atom supported[] = {targets, utf8_string, XA_STRING, text};
+        XChangeProperty(display, request.requestor, property, XA_ATOM, 32, PropModeReplace,
+                        reinterpret_cast<unsigned char*>(supported), 4);
+    } else if (request.target == utf8_string || request.target == XA_STRING || request.target == text) {
+        Atom type = request.target == text ? utf8_string : request.target;
+        XChangeProperty(display, request.requestor, property, type, 8, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(owned_text.data()),
+                        static_cast<int>(owned_text.size()));
+    } else {
+        reply.property = None;  // Unsupported target
+    }
+
+    XSendEvent(display, request.requestor, False, NoEventMask, reinterpret_cast<XEvent*>(&reply));
+    XFlush(display);
+}
+
+// Every event on GDK's connection passes through here before GDK sees it
+static gboolean on_xevent(GdkX11Display*, XEvent* event, gpointer data) {
+    auto* x11 = static_cast<ClipboardX11*>(data);
+
+    if (event->type == x11->xfixes_event_base + XFixesSelectionNotify) {
+        auto* notify = reinterpret_cast<XFixesSelectionNotifyEvent*>(event);
+        if (notify->window != x11->window) {
+            return FALSE;
+        }
+        // Ask the new owner for its text (our own ownership needs no recording)
+        if (notify->selection == x11->clipboard && notify->owner != None && notify->owner != x11->window) {
+            XConvertSelection(x11->display, x11->clipboard, x11->utf8_string, x11->property,
+                              x11->window, notify->selection_timestamp);
+            XFlush(x11->display);
+        }
+        return TRUE;
+    }
+
+    switch (event->type) {
+        case SelectionNotify: {
+            const XSelectionEvent& selection = event->xselection;
+            if (selection.requestor != x11->window) {
+                return FALSE;
+            }
+            if (selection.property == None) {
+                return TRUE;  // Owner had no text
+            }
+
+            Atom type = None;
+            int format = 0;
+            unsigned long count = 0;
+            unsigned long remaining = 0;
+            unsigned char* value = nullptr;
+            if (XGetWindowProperty(x11->display, x11->window, selection.property, 0,
+                                   MAX_ENTRY_BYTES / 4, True, AnyPropertyType, &type, &format,
+                                   &count, &remaining, &value) == Success) {
+                // Oversized (or INCR-transferred) text is not kept
+                if (format == 8 && remaining == 0 && (type == x11->utf8_string || type == XA_STRING)) {
+                    x11->history->add(std::string(reinterpret_cast<char*>(value), count));
+                }
+                if (value) {
+                    XFree(value);
+                }
+            }
+            return TRUE;
+        }
+
+        case SelectionRequest:
+            if (event->xselectionrequest.owner != x11->window) {
+                return FALSE;
+            }
+            x11->answer_request(event->xselectionrequest);
+            return TRUE;
+
+        case SelectionClear:
+            if (event->xselectionclear.window != x11->window) {
+                return FALSE;
+            }
+            x11->owned_text.clear();
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
+
+#else
+
+struct ClipboardX11 {};
+
+#endif
+
+ClipboardHistory::ClipboardHistory(size_t max_entries, size_t max_bytes)
+    : max_entries_(std::max<size_t>(max_entries, 1))
+    , max_bytes_(std::max<size_t>(max_bytes, 1024))
+{
+}
+
+ClipboardHistory::~ClipboardHistory() {
+#ifdef CLIPBOARD_X11
+    if (x11_) {
+        g_signal_handler_disconnect(x11_->gdk_display, x11_->handler_id);
+        XDestroyWindow(x11_->display, x11_->window);
+    }
+#endif
+}
+
+bool ClipboardHistory::start() {
+#ifdef CLIPBOARD_X11
+    if (x11_) {
+        return true;
+    }
+
+    GdkDisplay* gdk_display = gdk_display_get_default();
+    if (!gdk_display || !GDK_IS_X11_DISPLAY(gdk_display)) {
+        std::cerr << "Clipboard: History needs an X11 display\n";
+        return false;
+    }
+
+    auto x11 = std::make_unique<ClipboardX11>();
+    x11->history = this;
+    x11->gdk_display = gdk_display;
+    x11->display = gdk_x11_display_get_xdisplay(gdk_display);
+
+    int error_base = 0;
+    if (!XFixesQueryExtension(x11->display, &x11->xfixes_event_base, &error_base)) {
+        std::cerr << "Clipboard: XFixes extension not available\n";
+        return false;
+    }
+
+    x11->clipboard = XInternAtom(x11->display, "CLIPBOARD", False);
+    x11->utf8_string = XInternAtom(x11->display, "UTF8_STRING", False);
+    x11->targets = XInternAtom(x11->display, "TARGETS", False);
+    x11->text = XInternAtom(x11->display, "TEXT", False);
+    x11->property = XInternAtom(x11->display, "RADUX_CLIPBOARD", False);
+    x11->timestamp = XInternAtom(x11->display, "RADUX_TIMESTAMP", False);
+
+    // Unmapped window: receives converted selections and serves our own
+    x11->window = XCreateSimpleWindow(x11->display, DefaultRootWindow(x11->display),
+                                      -10, -10, 1, 1, 0, 0, 0);
+    XSelectInput(x11->display, x11->window, PropertyChangeMask);
+    XFixesSelectSelectionInput(x11->display, x11->window, x11->clipboard,
+                               XFixesSetSelectionOwnerNotifyMask);
+    XFlush(x11->display);
+
+    x11_ = std::move(x11);
+    x11_->handler_id = g_signal_connect(gdk_display, "xevent", G_CALLBACK(on_xevent), x11_.get());
+    return true;
+#else
+    std::cerr << "Clipboard: Built without X11/XFixes support\n";
+    return false;
+#endif
+}
+
+void ClipboardHistory::add(const std::string& text) {
+    if (text.empty() || text.size() > MAX_ENTRY_BYTES || text.size() > max_bytes_) {
+        return;
+    }
+
+    size_t hash = std::hash<std::string>{}(text);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Copying the same text again only moves it to the front
+    auto duplicate = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& entry) {
+        return entry.hash == hash && entry.text == text;
+    });
+    if (duplicate != entries_.end()) {
+        Entry entry = std::move(*duplicate);
+        entries_.erase(duplicate);
+        entries_.push_front(std::move(entry));
+        return;
+    }
+
+    entries_.push_front(Entry{text, hash});
+    total_bytes_ += text.size();
+
+    while (entries_.size() > max_entries_ || total_bytes_ > max_bytes_) {
+        total_bytes_ -= entries_.back().text.size();
+        entries_.pop_back();
+    }
+}
+
+bool ClipboardHistory::set_selection(const std::string& text) {
+#ifdef CLIPBOARD_X11
+    if (!x11_) {
+        return false;
+    }
+
+    x11_->owned_text = text;
+    x11_->owned_time = x11_->server_time();
+    XSetSelectionOwner(x11_->display, x11_->clipboard, x11_->window, x11_->owned_time);
+    if (XGetSelectionOwner(x11_->display, x11_->clipboard) != x11_->window) {
+        std::cerr << "Clipboard: Failed to take the selection\n";
+        x11_->owned_text.clear();
+        return false;
+    }
+
+    add(text);
+    return true;
+#else
+    (void)text;
+    return false;
+#endif
+}
+
+void ClipboardHistory::fetch(const std::string& /*arg*/, ProviderRequest& request) {
+    std::deque<Entry> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot = entries_;
+    }
+
+    std::weak_ptr<ClipboardHistory> weak = weak_from_this();
+    int index = 0;
+    for (const auto& entry : snapshot) {
+        MenuItem item;
+        item.label = make_label(entry.text);
+        item.description = Utf8Text::truncate(entry.text, DESCRIPTION_CHARS);
+        if (++index <= 9) {
+            item.hotkey = std::to_string(index);
+        }
+        item.action = [weak, text = entry.text]() {
+            if (auto history = weak.lock()) {
+                history->set_selection(text);
+            }
+        };
+
+        if (!request.emit(std::move(item))) {
+            return;
+        }
+    }
+}
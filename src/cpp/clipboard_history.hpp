@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "menu_provider.hpp"
+
+// Built-in "clipboard" provider: recent CLIPBOARD text, recorded in-process
+// Ownership changes arrive as XFixes events on GDK's own X11 connection, so
+// nothing is polled and no helper process runs. Choosing an entry makes this
+// process the CLIPBOARD owner serving that text. Only the resident (--daemon)
+// instance records history
+class ClipboardHistory : public MenuProvider,
+                         public std::enable_shared_from_this<ClipboardHistory> {
+public:
+    // max_entries: entries kept; max_bytes: total text kept (oldest evicted first)
+    ClipboardHistory(size_t max_entries, size_t max_bytes);
+    ~ClipboardHistory() override;
+
+    // Prevent copying
+    ClipboardHistory(const ClipboardHistory&) = delete;
+    ClipboardHistory& operator=(const ClipboardHistory&) = delete;
+
+    // GTK thread: subscribe to selection changes (X11 with XFixes only)
+    bool start();
+
+    ProviderCachePolicy cache_policy() const override { return {}; }
+    void fetch(const std::string& arg, ProviderRequest& request) override;
+
+    // GTK thread: record text, moving a duplicate to the front
+    void add(const std::string& text);
+
+    // GTK thread: own CLIPBOARD and serve text to paste requests
+    bool set_selection(const std::string& text);
+
+private:
+    struct Entry {
+        std::string text;
+        size_t hash;
+    };
+
+    size_t max_entries_;
+    size_t max_bytes_;
+
+    // Newest first (guarded by mutex_, read by workers)
+    std::mutex mutex_;
+    std::deque<Entry> entries_;
+    size_t total_bytes_ = 0;
+
+    // X11 connection state (defined in the .cpp, empty without X11/XFixes)
+    std::unique_ptr<struct ClipboardX11> x11_;
+};
@@ -1,6 +1,7 @@
 #include "color_theme.hpp"
 #include <yaml-cpp/yaml.h>
-#include <sstream>
+#include <cctype>
+#include <string>
 #include <algorithm>
 #include <cmath>
 
@@ -16,37 +17,26 @@ Color Color::from_hex(const std::string& hex) {
 
     // Parse #RRGGBB or #RRGGBBAA
     if (h.length() >= 6) {
-        try {
-            unsigned int value;
-            std::stringstream ss;
-
-            // Red
-            ss << std::hex << h.substr(0, 2);
-            ss >> value;
-            c.r = value / 255.0;
-            ss.clear();
+        // Any non-hex digit leaves the color transparent (unset)
+        size_t digits = h.length() >= 8 ? 8 : 6;
+        for (size_t i = 0; i < digits; ++i) {
+            if (!std::isxdigit(static_cast<unsigned char>(h[i]))) {
+                c.a = 0.0;
+                return c;
+            }
+        }
 
-            // Green
-            ss << std::hex << h.substr(2, 2);
-            ss >> value;
-            c.g = value / 255.0;
-            ss.clear();
+        auto channel = [&h](size_t offset) {
+            return std::stoul(h.substr(offset, 2), nullptr, 16) / 255.0;
+        };
 
-            // Blue
-            ss << std::hex << h.substr(4, 2);
-            ss >> value;
-            c.b = value / 255.0;
-            ss.clear();
+        c.r = channel(0);
+        c.g = channel(2);
+        c.b = channel(4);
 
-            // Alpha (optional)
-            if (h.length() >= 8) {
-                ss << std::hex << h.substr(6, 2);
-                ss >> value;
-                c.a = value / 255.0;
-            }
-        } catch (...) {
-            // If parsing fails, return transparent (unset)
-            c.a = 0.0;
+        // Alpha (optional)
+        if (digits == 8) {
+            c.a = channel(6);
         }
     }
 
@@ -1,17 +1,104 @@
 #include "config_loader.hpp"
 #include "command_blacklist.hpp"
+#include "memory_stats.hpp"
 #include <yaml-cpp/yaml.h>
 #include <sstream>
+#include <fstream>
+#include <iterator>
 #include <algorithm>
 #include <cctype>
 #include <iostream>
 #include <filesystem>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+// Limits that keep load time bounded for generated or hostile configs
+static const uintmax_t MAX_CONFIG_BYTES = 4 << 20;
+static const int MAX_MENU_DEPTH = 16;
+static const size_t MAX_MENU_ITEMS = 10000;  // Counted after alias expansion
+
+// yaml-cpp builds the whole document, recursing once per nesting level,
+// before any limit above is checked. Block nesting costs an indent per level,
+// so MAX_CONFIG_BYTES keeps it to a few thousand levels; flow nesting costs a
+// byte per level and is refused past this (a menu needs two per submenu)
+static const int MAX_FLOW_DEPTH = 256;
+
+// Deepest [ ] / { } nesting of a YAML text, outside quotes and comments
+static int max_flow_depth(const std::string& text) {
+    int depth = 0;
+    int deepest = 0;
+    char quote = 0;
+    char previous = '\n';
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (quote) {
+            if (c == '\\' && quote == '"') {
+                ++i;
+            } else if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '#' && std::isspace(static_cast<unsigned char>(previous))) {
+            i = std::min(text.find('\n', i), text.size());
+            c = '\n';
+        } else if ((c == '"' || c == '\'') &&
+                   (std::isspace(static_cast<unsigned char>(previous)) || std::strchr("[{,:-", previous))) {
+            quote = c;
+        } else if (c == '[' || c == '{') {
+            deepest = std::max(deepest, ++depth);
+        } else if ((c == ']' || c == '}') && depth > 0) {
+            --depth;
+        }
+        previous = c;
+    }
+    return deepest;
+}
+
+// Expand a leading ~ and drop trailing slashes, so one directory has one cache key
+static std::string normalize_browse_path(const std::string& path) {
+    std::string result = path;
+    if (!result.empty() && result[0] == '~') {
+        const char* home = std::getenv("HOME");
+        if (home) {
+            result = std::string(home) + result.substr(1);
+        }
+    }
+    while (result.size() > 1 && result.back() == '/') {
+        result.pop_back();
+    }
+    return result;
+}
 
 RadialConfig RadialConfig::from_yaml(const std::string& filepath) {
     RadialConfig config;
 
+    // Refuse oversized files before the YAML parser sees them
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(filepath, ec);
+    if (!ec && size > MAX_CONFIG_BYTES) {
+        std::cerr << "Error loading YAML: " << filepath << " is larger than "
+                  << (MAX_CONFIG_BYTES >> 20) << " MB\n";
+        return config;
+    }
+
     try {
-        YAML::Node yaml_config = YAML::LoadFile(filepath);
+        YAML::Node yaml_config;
+        {
+            // Read once, so the text checked is the text parsed
+            std::ifstream file(filepath, std::ios::binary);
+            if (!file) {
+                throw YAML::BadFile(filepath);
+            }
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (max_flow_depth(text) > MAX_FLOW_DEPTH) {
+                std::cerr << "Error loading YAML: " << filepath << " nests [ ] or { } deeper than "
+                          << MAX_FLOW_DEPTH << " levels\n";
+                return config;
+            }
+            MemoryScope memory(MemoryTag::Yaml);
+            yaml_config = YAML::Load(text);
+        }
+        MemoryScope memory(MemoryTag::Config);
 
         // Read radius
         if (yaml_config["radius"]) {
@@ -62,10 +149,60 @@ RadialConfig RadialConfig::from_yaml(const std::string& filepath) {
             config.auto_close_milliseconds = yaml_config["auto-close-milliseconds"].as<int>();
         }
 
+        // Parse breadcrumbs
+        if (yaml_config["breadcrumbs"]) {
+            config.breadcrumbs = yaml_config["breadcrumbs"].as<bool>();
+        }
+
+        // Parse remote mode ("auto", "on"/"always", "off"/"never")
+        if (yaml_config["remote-mode"]) {
+            std::string mode = yaml_config["remote-mode"].as<std::string>();
+            std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+            if (mode == "on" || mode == "always" || mode == "true") {
+                config.remote_mode = RemoteMode::Always;
+            } else if (mode == "off" || mode == "never" || mode == "false") {
+                config.remote_mode = RemoteMode::Never;
+            } else {
+                config.remote_mode = RemoteMode::Auto;
+            }
+        }
+
+        // Parse wedge rasterizer
+        if (yaml_config["renderer"]) {
+            std::string renderer = yaml_config["renderer"].as<std::string>();
+            std::transform(renderer.begin(), renderer.end(), renderer.begin(), ::tolower);
+            config.renderer = renderer == "analytic" ? Renderer::Analytic : Renderer::Cairo;
+        }
+
+        // Parse filesystem browsing options
+        if (yaml_config["browse-opener"]) {
+            config.browse_opener = yaml_config["browse-opener"].as<std::string>();
+        }
+        if (yaml_config["browse-limit"]) {
+            config.browse_limit = std::clamp(yaml_config["browse-limit"].as<int>(), 1, 1000);
+        }
+        if (yaml_config["browse-hidden"]) {
+            config.browse_hidden = yaml_config["browse-hidden"].as<bool>();
+        }
+        if (yaml_config["recent-limit"]) {
+            config.recent_limit = std::clamp(yaml_config["recent-limit"].as<int>(), 1, 100);
+        }
+        if (yaml_config["clipboard-entries"]) {
+            config.clipboard_entries = std::clamp(yaml_config["clipboard-entries"].as<int>(), 1, 500);
+        }
+        if (yaml_config["clipboard-max-kb"]) {
+            config.clipboard_max_kb = std::clamp(yaml_config["clipboard-max-kb"].as<int>(), 1, 65536);
+        }
+
         // Read items
         if (yaml_config["items"]) {
+            size_t budget = MAX_MENU_ITEMS;
             for (const auto& item : yaml_config["items"]) {
-                MenuItem menu_item = parse_menu_item(item, config.theme);
+                if (budget == 0) {
+                    std::cerr << "Warning: More than " << MAX_MENU_ITEMS << " items, ignoring the rest\n";
+                    break;
+                }
+                MenuItem menu_item = parse_menu_item(item, config.theme, 0, budget);
                 if (menu_item.is_valid()) {
                     config.items.push_back(menu_item);
                 }
@@ -78,10 +215,17 @@ RadialConfig RadialConfig::from_yaml(const std::string& filepath) {
     return config;
 }
 
-MenuItem RadialConfig::parse_menu_item(const YAML::Node& node, const Theme& parent_theme) {
+MenuItem RadialConfig::parse_menu_item(const YAML::Node& node, const Theme& parent_theme,
+                                       int depth, size_t& budget) {
     MenuItem item;
 
-    if (!node["label"]) {
+    // Aliases can make a small file expand into a huge tree: every parsed item counts
+    if (budget == 0) {
+        return item;
+    }
+    --budget;
+
+    if (!node.IsMap() || !node["label"]) {
         std::cerr << "Warning: Item missing label, skipping\n";
         return item;
     }
@@ -90,6 +234,16 @@ MenuItem RadialConfig::parse_menu_item(const YAML::Node& node, const Theme& pare
     item.command = node["command"] ? node["command"].as<std::string>() : "";
     item.description = node["description"] ? node["description"].as<std::string>() : "";
 
+    // Parse desktop-id (application launched by .desktop ID)
+    if (node["desktop-id"]) {
+        item.desktop_id = node["desktop-id"].as<std::string>();
+    }
+
+    // Parse raise-class (existing window activated instead of starting another)
+    if (node["raise-class"]) {
+        item.raise_class = node["raise-class"].as<std::string>();
+    }
+
     // Parse icon
     if (node["icon"]) {
         item.icon = node["icon"].as<std::string>();
@@ -111,6 +265,23 @@ MenuItem RadialConfig::parse_menu_item(const YAML::Node& node, const Theme& pare
         item.notify = node["notify"].as<bool>();
     }
 
+    // Parse cache-ttl (seconds a notify item's output is reused)
+    if (node["cache-ttl"]) {
+        item.cache_ttl = std::max(node["cache-ttl"].as<int>(), 0);
+    }
+
+    // Parse provider (dynamic submenu)
+    if (node["provider"]) {
+        item.provider = node["provider"].as<std::string>();
+        item.provider_arg = node["provider-arg"] ? node["provider-arg"].as<std::string>() : "";
+    }
+
+    // Parse browse (filesystem submenu, shorthand for the "browse" provider)
+    if (node["browse"]) {
+        item.provider = "browse";
+        item.provider_arg = normalize_browse_path(node["browse"].as<std::string>());
+    }
+
     // Parse theme override (item-level colors)
     if (node["background-color"] || node["hover-color"] ||
         node["border-color"] || node["font-color"]) {
@@ -118,19 +289,26 @@ MenuItem RadialConfig::parse_menu_item(const YAML::Node& node, const Theme& pare
     }
 
     // Handle color-inheritance for submenus
-    if (node["submenu"]) {
+    if (node["submenu"] && depth >= MAX_MENU_DEPTH) {
+        std::cerr << "Warning: Submenu of '" << item.label << "' nested deeper than "
+                  << MAX_MENU_DEPTH << " levels, skipping\n";
+        return MenuItem();
+    } else if (node["submenu"]) {
         // Get effective theme for this submenu (inherits from parent if item has colors)
         Theme effective_theme = item.get_effective_theme(parent_theme);
 
         for (const auto& sub : node["submenu"]) {
-            MenuItem subitem = parse_menu_item(sub, effective_theme);
+            if (budget == 0) {
+                break;
+            }
+            MenuItem subitem = parse_menu_item(sub, effective_theme, depth + 1, budget);
             if (subitem.is_valid()) {
                 item.submenu.push_back(subitem);
             }
         }
-    } else {
-        // Leaf item - must have command
-        if (item.command.empty()) {
+    } else if (!item.is_dynamic()) {
+        // Leaf item - must have command (or an application to start)
+        if (!item.launches()) {
             std::cerr << "Warning: Item '" << item.label << "' missing command, skipping\n";
             return MenuItem(); // Return invalid item
         }
@@ -140,6 +318,7 @@ MenuItem RadialConfig::parse_menu_item(const YAML::Node& node, const Theme& pare
 }
 
 RadialConfig RadialConfig::from_command_line(const std::string& cli_string) {
+    MemoryScope memory(MemoryTag::Config);
     RadialConfig config;
     std::vector<MenuItem> items;
 
@@ -151,6 +330,11 @@ RadialConfig RadialConfig::from_command_line(const std::string& cli_string) {
         item_str.erase(0, item_str.find_first_not_of(" \t"));
         item_str.erase(item_str.find_last_not_of(" \t") + 1);
 
+        if (items.size() >= MAX_MENU_ITEMS) {
+            std::cerr << "Warning: More than " << MAX_MENU_ITEMS << " items, ignoring the rest\n";
+            break;
+        }
+
         if (!item_str.empty()) {
             MenuItem item = parse_cli_item(item_str);
             if (item.is_valid()) {
@@ -231,6 +415,13 @@ bool RadialConfig::validate() const {
         }
     }
 
+    // The opener runs for every file picked in a "browse:" submenu
+    if (blacklist.is_blacklisted(browse_opener) || blacklist.has_dangerous_patterns(browse_opener)) {
+        std::cerr << "SECURITY ERROR in config: " << blacklist.get_blacklisted_info(browse_opener) << "\n";
+        std::cerr << "  Setting: browse-opener\n";
+        return false;
+    }
+
     return true;
 }
 
@@ -13,6 +13,19 @@ namespace YAML {
 // Forward declaration for blacklist
 class CommandBlacklist;
 
+// Remote X11 session handling
+enum class RemoteMode {
+    Auto,    // Enabled when DISPLAY points at another host
+    Always,
+    Never
+};
+
+// How menu wedges are rasterized
+enum class Renderer {
+    Cairo,     // Generic Cairo paths
+    Analytic   // Annular sectors filled from their distance field (sector_raster)
+};
+
 class RadialConfig {
 public:
     // Geometry
@@ -31,6 +44,27 @@ public:
     // Auto-close
     int auto_close_milliseconds = 0; // 0 = disabled
 
+    // Outer ring of ancestor levels for jumping back several levels at once
+    bool breadcrumbs = false;
+
+    // Low-round-trip mode for SSH forwarding / thin clients
+    RemoteMode remote_mode = RemoteMode::Auto;
+
+    // Wedge and center rasterizer
+    Renderer renderer = Renderer::Cairo;
+
+    // Filesystem browsing ("browse:" items)
+    std::string browse_opener = "xdg-open";   // Receives the chosen file path
+    int browse_limit = 64;                    // Entries shown per directory
+    bool browse_hidden = false;               // Show dotfiles
+
+    // Recent documents ("recent" provider)
+    int recent_limit = 12;                    // Documents shown (opened with browse_opener)
+
+    // Clipboard history ("clipboard" provider, resident instance only)
+    int clipboard_entries = 25;               // Entries kept
+    int clipboard_max_kb = 1024;              // Total text kept
+
     // Load from YAML file
     static RadialConfig from_yaml(const std::string& filepath);
 
@@ -41,12 +75,17 @@ public:
     // Validate configuration
     bool validate() const;
 
+    // Fuzzing harness for single items (fuzz/fuzz_cli_item.cpp)
+    friend class CliItemFuzzer;
+
 private:
     // Helper to parse single item from CLI string
     static MenuItem parse_cli_item(const std::string& item_str);
 
     // Helper to parse menu item from YAML node
-    static MenuItem parse_menu_item(const YAML::Node& node, const Theme& parent_theme);
+    // depth: submenu nesting of node; budget: items that may still be parsed
+    static MenuItem parse_menu_item(const YAML::Node& node, const Theme& parent_theme,
+                                    int depth, size_t& budget);
 
     // Validate commands in menu items (recursive for submenus)
     bool validate_item_commands(const MenuItem& item, CommandBlacklist& blacklist) const;
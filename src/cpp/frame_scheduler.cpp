@@ -0,0 +1,150 @@
+#include "frame_scheduler.hpp"
+#include <glibmm/main.h>
+#include <algorithm>
+#include <iostream>
+
+// Kept free before the next frame is due
+static const gint64 SAFETY_MARGIN_US = 1000;
+
+// Budget of one idle dispatch while no frame is coming
+static const gint64 IDLE_SLICE_US = 4000;
+
+// Used until the clock reports a refresh rate
+static const gint64 DEFAULT_REFRESH_US = 16667;
+
+void FrameScheduler::post(SlackPriority priority, CancelToken token, Job job) {
+    queues_[static_cast<size_t>(priority)].push_back({std::move(token), std::move(job)});
+    if (!wakeup_.connected()) {
+        schedule_wakeup(0);
+    }
+}
+
+void FrameScheduler::attach(const Glib::RefPtr<Gdk::FrameClock>& clock) {
+    after_paint_.disconnect();
+    clock_ = clock;
+    next_frame_ = 0;
+    if (clock_) {
+        after_paint_ = clock_->signal_after_paint().connect(
+            sigc::mem_fun(*this, &FrameScheduler::on_after_paint));
+    }
+}
+
+void FrameScheduler::detach(const Glib::RefPtr<Gdk::FrameClock>& clock) {
+    if (clock_ == clock) {
+        after_paint_.disconnect();
+        clock_.reset();
+    }
+}
+
+void FrameScheduler::on_after_paint() {
+    gint64 now = g_get_monotonic_time();
+    gint64 frame_time = clock_->get_frame_time();
+    gint64 interval = 0;
+    gint64 presentation = 0;
+    gdk_frame_clock_get_refresh_info(clock_->gobj(), frame_time, &interval, &presentation);
+
+    refresh_interval_ = interval > 0 ? interval : DEFAULT_REFRESH_US;
+    next_frame_ = frame_time + refresh_interval_;
+    frame_cost_ = (frame_cost_ * 3 + std::clamp<gint64>(now - frame_time, 0, refresh_interval_)) / 4;
+
+    if (!has_work()) {
+        return;
+    }
+
+    // This is the slack a waiting wakeup was holding out for
+    wakeup_.disconnect();
+    run_until(next_frame_ - frame_cost_ - SAFETY_MARGIN_US);
+    if (has_work()) {
+        schedule_wakeup(0);
+    }
+}
+
+bool FrameScheduler::on_wakeup() {
+    gint64 now = g_get_monotonic_time();
+    gint64 deadline = now + IDLE_SLICE_US;
+
+    // Frames still coming: only the gap before the next one is free
+    if (clock_ && now < next_frame_ + refresh_interval_) {
+        deadline = next_frame_ - frame_cost_ - SAFETY_MARGIN_US;
+        if (now >= deadline) {
+            // Left to the next after-paint; the timeout covers a clock that went quiet
+            gint64 quiet = next_frame_ + refresh_interval_ - now;
+            schedule_wakeup(static_cast<unsigned int>(quiet / 1000 + 1));
+            return false;
+        }
+    }
+
+    run_until(deadline);
+    return has_work();
+}
+
+void FrameScheduler::schedule_wakeup(unsigned int delay_ms) {
+    // Below GDK's redraw priority, so a frame that is due always goes first
+    if (delay_ms == 0) {
+        wakeup_ = Glib::signal_idle().connect(
+            sigc::mem_fun(*this, &FrameScheduler::on_wakeup), Glib::PRIORITY_DEFAULT_IDLE);
+    } else {
+        wakeup_ = Glib::signal_timeout().connect(
+            sigc::mem_fun(*this, &FrameScheduler::on_wakeup), delay_ms, Glib::PRIORITY_DEFAULT_IDLE);
+    }
+}
+
+void FrameScheduler::run_until(gint64 deadline) {
+    while (g_get_monotonic_time() < deadline) {
+        auto queue = std::find_if(std::begin(queues_), std::end(queues_),
+                                  [](const std::deque<Entry>& q) { return !q.empty(); });
+        if (queue == std::end(queues_)) {
+            return;
+        }
+
+        Entry entry = std::move(queue->front());
+        queue->pop_front();
+        if (entry.token.is_cancelled()) {
+            continue;
+        }
+
+        bool more = false;
+        try {
+            more = entry.job();
+        } catch (const std::exception& e) {
+            std::cerr << "FrameScheduler: Job failed: " << e.what() << "\n";
+        }
+
+        // Unfinished work keeps its place ahead of later posts
+        if (more) {
+            queue->push_front(std::move(entry));
+        }
+    }
+}
+
+bool FrameScheduler::has_work() const {
+    return std::any_of(std::begin(queues_), std::end(queues_),
+                       [](const std::deque<Entry>& q) { return !q.empty(); });
+}
+
+SlackAwaiter::~SlackAwaiter() {
+    if (cancel_id_ != 0) {
+        token_.remove(cancel_id_);
+    }
+}
+
+void SlackAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    if (token_.is_cancelled()) {
+        handle.destroy();
+        return;
+    }
+
+    handle_ = handle;
+    cancel_id_ = token_.on_cancel([this]() {
+        cancel_id_ = 0;
+        handle_.destroy();
+    });
+
+    // A cancelled token drops the job, so it never sees a destroyed awaiter
+    FrameScheduler::instance().post(priority_, token_, [this]() {
+        token_.remove(cancel_id_);
+        cancel_id_ = 0;
+        handle_.resume();
+        return false;
+    });
+}
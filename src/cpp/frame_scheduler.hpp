@@ -0,0 +1,92 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <gdkmm/frameclock.h>
+#include "main_loop_task.hpp"
+
+// Order in which queued main-thread work gets the slack
+enum class SlackPriority {
+    Visible,      // Needed by the level on screen
+    Prefetch,     // The user is pointing at it
+    Speculative,  // Might be needed later
+    Count
+};
+
+// Runs GTK-thread work in the time left over after each frame
+// While a frame clock is animating, jobs run right after its paint phase
+// until the next frame is due, minus what frames have recently cost; when no
+// frame is coming, they run from a low-priority idle in short slices. Either
+// way input and redraws are never held up by more than one job
+class FrameScheduler {
+public:
+    // One slice of work; true if there is more (run again in a later slice)
+    using Job = std::function<bool()>;
+
+    static FrameScheduler& instance() {
+        static FrameScheduler inst;
+        return inst;
+    }
+
+    // Prevent copying
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    // GTK thread. The job is dropped without running once token is cancelled
+    void post(SlackPriority priority, CancelToken token, Job job);
+
+    // Take frame timings from this clock (a realized window's); the latest wins
+    void attach(const Glib::RefPtr<Gdk::FrameClock>& clock);
+    void detach(const Glib::RefPtr<Gdk::FrameClock>& clock);
+
+private:
+    FrameScheduler() = default;
+
+    struct Entry {
+        CancelToken token;
+        Job job;
+    };
+
+    void on_after_paint();
+    bool on_wakeup();
+    void schedule_wakeup(unsigned int delay_ms);
+    void run_until(gint64 deadline);
+    bool has_work() const;
+
+    std::deque<Entry> queues_[static_cast<size_t>(SlackPriority::Count)];
+
+    Glib::RefPtr<Gdk::FrameClock> clock_;
+    sigc::connection after_paint_;
+    sigc::connection wakeup_;
+
+    // From the last painted frame (monotonic microseconds)
+    gint64 next_frame_ = 0;       // When the following frame starts
+    gint64 refresh_interval_ = 0;
+    gint64 frame_cost_ = 0;       // Recent main-thread time per frame (smoothed)
+};
+
+// Resume once the scheduler gives this priority its turn
+class SlackAwaiter {
+public:
+    SlackAwaiter(CancelToken token, SlackPriority priority)
+        : token_(std::move(token)), priority_(priority) {}
+    ~SlackAwaiter();
+
+    // Prevent copying
+    SlackAwaiter(const SlackAwaiter&) = delete;
+    SlackAwaiter& operator=(const SlackAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept {}
+
+private:
+    CancelToken token_;
+    SlackPriority priority_;
+    std::coroutine_handle<> handle_;
+    size_t cancel_id_ = 0;
+};
+
+inline SlackAwaiter in_frame_slack(CancelToken token, SlackPriority priority) {
+    return SlackAwaiter(std::move(token), priority);
+}
@@ -0,0 +1,20 @@
+// libFuzzer entry point: one command-line item ("title:description:action")
+
+#include "config_loader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Reaches the private item parser (a friend of RadialConfig)
+class CliItemFuzzer {
+public:
+    static void run(const std::string& input) {
+        RadialConfig::parse_cli_item(input);
+    }
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string input(reinterpret_cast<const char*>(data), size);
+    CliItemFuzzer::run(input);
+    return 0;
+}
@@ -0,0 +1,12 @@
+// libFuzzer entry point: theme colors ("#RRGGBB", "#RRGGBBAA")
+
+#include "color_theme.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string input(reinterpret_cast<const char*>(data), size);
+    Color::from_hex(input);
+    return 0;
+}
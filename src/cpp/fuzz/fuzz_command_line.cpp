@@ -0,0 +1,12 @@
+// libFuzzer entry point: a whole --cli string ("item;item;...")
+
+#include "config_loader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string input(reinterpret_cast<const char*>(data), size);
+    RadialConfig::from_command_line(input);
+    return 0;
+}
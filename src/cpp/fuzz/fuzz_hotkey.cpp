@@ -0,0 +1,12 @@
+// libFuzzer entry point: hotkey combos ("ctrl+shift+t")
+
+#include "hotkey_manager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string input(reinterpret_cast<const char*>(data), size);
+    Hotkey::from_string(input);
+    return 0;
+}
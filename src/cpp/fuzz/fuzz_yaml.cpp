@@ -0,0 +1,42 @@
+// libFuzzer entry point: config files
+// from_yaml() reads a path (its size check runs before parsing), so every
+// input is written to one scratch file first
+
+#include "config_loader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+static std::string scratch_path;
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+    char path[] = "/tmp/radux-fuzz-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        std::perror("mkstemp");
+        std::exit(1);
+    }
+    close(fd);
+    scratch_path = path;
+    std::atexit([]() { unlink(scratch_path.c_str()); });
+
+    // Rejected configs are expected; their messages would bury libFuzzer's output
+    std::cerr.rdbuf(nullptr);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    FILE* file = std::fopen(scratch_path.c_str(), "wb");
+    if (!file) {
+        return 0;
+    }
+    std::fwrite(data, 1, size, file);
+    std::fclose(file);
+
+    RadialConfig::from_yaml(scratch_path);
+    return 0;
+}
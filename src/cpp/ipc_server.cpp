@@ -0,0 +1,363 @@
+#include "ipc_server.hpp"
+#include "app_launcher.hpp"
+#include "command_blacklist.hpp"
+#include <yaml-cpp/yaml.h>
+#include <giomm/unixsocketaddress.h>
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Requests larger than this are rejected (a menu is a few KB at most)
+static const size_t MAX_REQUEST_BYTES = 1 << 20;
+
+// Bytes asked for per read while collecting a request line
+static const gsize READ_CHUNK_BYTES = 16 * 1024;
+
+// Deepest submenu nesting accepted from clients
+static const int MAX_IPC_DEPTH = 16;
+
+// Most items accepted per request (YAML aliases can expand a short line)
+static const size_t MAX_IPC_ITEMS = 4096;
+
+// Escape a string for use inside a JSON string literal
+static std::string json_escape(const std::string& str) {
+    std::string result;
+    result.reserve(str.size() + 2);
+
+    for (char c : str) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    result += buffer;
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+
+    return result;
+}
+
+// Parse one menu item from a request
+// JSON is read through yaml-cpp, which also takes YAML flow syntax (unquoted
+// or single-quoted strings, comments, aliases); clients must not rely on it
+static bool parse_ipc_item(const YAML::Node& node, int depth, size_t& budget,
+                           MenuItem& item, std::string& error) {
+    if (budget == 0) {
+        error = "too many items";
+        return false;
+    }
+    --budget;
+
+    if (!node.IsMap()) {
+        error = "menu item must be an object";
+        return false;
+    }
+    if (!node["label"]) {
+        error = "menu item missing label";
+        return false;
+    }
+
+    item.label = node["label"].as<std::string>();
+    item.id = node["id"] ? node["id"].as<std::string>() : item.label;
+    item.command = node["command"] ? node["command"].as<std::string>() : "";
+    item.description = node["description"] ? node["description"].as<std::string>() : "";
+    item.desktop_id = node["desktop-id"] ? node["desktop-id"].as<std::string>() : "";
+    item.raise_class = node["raise-class"] ? node["raise-class"].as<std::string>() : "";
+
+    if (node["icon"]) {
+        item.icon = node["icon"].as<std::string>();
+    }
+    if (node["hotkey"]) {
+        item.hotkey = node["hotkey"].as<std::string>();
+    }
+    if (node["priority"]) {
+        item.priority = std::clamp(node["priority"].as<int>(), 0, 10);
+    }
+    if (node["notify"]) {
+        item.notify = node["notify"].as<bool>();
+    }
+    if (node["cache-ttl"]) {
+        item.cache_ttl = std::max(node["cache-ttl"].as<int>(), 0);
+    }
+    if (node["provider"]) {
+        item.provider = node["provider"].as<std::string>();
+        item.provider_arg = node["provider-arg"] ? node["provider-arg"].as<std::string>() : "";
+    }
+
+    if (node["submenu"]) {
+        if (depth >= MAX_IPC_DEPTH) {
+            error = "submenu nesting too deep";
+            return false;
+        }
+        if (!node["submenu"].IsSequence()) {
+            error = "submenu of '" + item.label + "' must be an array";
+            return false;
+        }
+
+        for (const auto& sub : node["submenu"]) {
+            MenuItem subitem;
+            if (!parse_ipc_item(sub, depth + 1, budget, subitem, error)) {
+                return false;
+            }
+            item.submenu.push_back(subitem);
+        }
+    }
+
+    // SECURITY: Only items that execute something need a policy check
+    // (a command replaces the Exec line of a desktop-id, so it is all that runs)
+    if (!item.command.empty()) {
+        auto& blacklist = CommandBlacklist::instance();
+        if (blacklist.is_blacklisted(item.command) || blacklist.has_dangerous_patterns(item.command)) {
+            error = blacklist.get_blacklisted_info(item.command) + " (item '" + item.label + "')";
+            return false;
+        }
+    } else if (!item.desktop_id.empty()) {
+        std::string refusal = AppLauncher::exec_refusal(item.desktop_id);
+        if (!refusal.empty()) {
+            error = refusal + " (item '" + item.label + "')";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+IpcServer::IpcServer(const std::string& socket_path)
+    : socket_path_(socket_path)
+{
+}
+
+IpcServer::~IpcServer() {
+    stop();
+}
+
+std::string IpcServer::default_socket_path() {
+    const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && runtime_dir[0] != '\0') {
+        return std::string(runtime_dir) + "/radux.sock";
+    }
+    return "/tmp/radux-" + std::to_string(getuid()) + ".sock";
+}
+
+bool IpcServer::start(const RequestHandler& handler) {
+    handler_ = handler;
+
+    // A socket left behind by a crashed daemon would make bind() fail; one
+    // that still answers belongs to a running daemon and is left alone
+    struct stat info;
+    if (lstat(socket_path_.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            std::cerr << "IPC: " << socket_path_ << " exists and is not a socket\n";
+            return false;
+        }
+        try {
+            Gio::SocketClient::create()->connect(Gio::UnixSocketAddress::create(socket_path_))->close();
+            std::cerr << "IPC: Another daemon is listening on " << socket_path_ << "\n";
+            return false;
+        } catch (const Glib::Error&) {
+            std::remove(socket_path_.c_str());
+        }
+    }
+
+    // SECURITY: Only the owning user may push menus. The mode is set by the
+    // umask at bind(), so there is no moment where others could connect
+    service_ = Gio::SocketService::create();
+    mode_t old_umask = umask(S_IRWXG | S_IRWXO);
+    try {
+        service_->add_address(Gio::UnixSocketAddress::create(socket_path_),
+                              Gio::Socket::Type::STREAM,
+                              Gio::Socket::Protocol::DEFAULT);
+    } catch (const Glib::Error& e) {
+        umask(old_umask);
+        std::cerr << "IPC: Failed to listen on " << socket_path_ << ": " << e.what() << "\n";
+        service_.reset();
+        return false;
+    }
+    umask(old_umask);
+
+    service_->signal_incoming().connect(sigc::mem_fun(*this, &IpcServer::on_incoming), false);
+    service_->start();
+
+    std::cerr << "IPC: Listening on " << socket_path_ << "\n";
+    return true;
+}
+
+void IpcServer::stop() {
+    if (service_) {
+        service_->stop();
+        service_->close();
+        service_.reset();
+        std::remove(socket_path_.c_str());
+    }
+}
+
+// One client connection; bytes up to the first newline are its request
+struct PendingRequest {
+    Glib::RefPtr<Gio::SocketConnection> connection;
+    IpcServer::RequestHandler handler;
+    std::string buffer;
+};
+
+static void write_reply(const Glib::RefPtr<Gio::SocketConnection>& connection, const std::string& reply) {
+    try {
+        gsize bytes_written = 0;
+        connection->get_output_stream()->write_all(reply + "\n", bytes_written);
+        connection->close();
+    } catch (const Glib::Error& e) {
+        std::cerr << "IPC: Failed to send reply: " << e.what() << "\n";
+    }
+}
+
+static void handle_request(const std::shared_ptr<PendingRequest>& pending, const std::string& line) {
+    IpcMenuRequest request;
+    std::string error;
+    if (!IpcServer::parse_request(line, request, error)) {
+        write_reply(pending->connection, IpcServer::format_error(error));
+        return;
+    }
+
+    auto connection = pending->connection;
+    pending->handler(request, [connection](const MenuItem* selected) {
+        write_reply(connection, IpcServer::format_reply(selected));
+    });
+}
+
+static void read_request(const std::shared_ptr<PendingRequest>& pending) {
+    auto input = pending->connection->get_input_stream();
+    input->read_bytes_async(READ_CHUNK_BYTES, [pending, input](Glib::RefPtr<Gio::AsyncResult>& result) {
+        Glib::RefPtr<Glib::Bytes> bytes;
+        try {
+            bytes = input->read_bytes_finish(result);
+        } catch (const Glib::Error& e) {
+            std::cerr << "IPC: Failed to read request: " << e.what() << "\n";
+            pending->connection->close();
+            return;
+        }
+
+        gsize size = 0;
+        const char* data = bytes ? static_cast<const char*>(bytes->get_data(size)) : nullptr;
+        if (size == 0) {
+            // End of stream: an unterminated last line still counts
+            if (pending->buffer.empty()) {
+                pending->connection->close();
+            } else {
+                handle_request(pending, pending->buffer);
+            }
+            return;
+        }
+
+        size_t searched = pending->buffer.size();
+        pending->buffer.append(data, size);
+        size_t newline = pending->buffer.find('\n', searched);
+
+        // Checked per chunk, so a client that never ends its line cannot grow the buffer
+        if (std::min(newline, pending->buffer.size()) > MAX_REQUEST_BYTES) {
+            write_reply(pending->connection, IpcServer::format_error("request too large"));
+            return;
+        }
+        if (newline == std::string::npos) {
+            read_request(pending);
+            return;
+        }
+
+        handle_request(pending, pending->buffer.substr(0, newline));
+    });
+}
+
+bool IpcServer::on_incoming(const Glib::RefPtr<Gio::SocketConnection>& connection,
+                            const Glib::RefPtr<Glib::Object>& /*source_object*/) {
+    // Copy the handler so pending reads never touch a stopped server
+    read_request(std::make_shared<PendingRequest>(PendingRequest{connection, handler_, {}}));
+    return true;
+}
+
+bool IpcServer::parse_request(const std::string& line, IpcMenuRequest& request, std::string& error) {
+    try {
+        YAML::Node root = YAML::Load(line);
+        if (!root.IsMap()) {
+            error = "request must be an object";
+            return false;
+        }
+
+        if (root["x"] && root["y"]) {
+            request.x = root["x"].as<int>();
+            request.y = root["y"].as<int>();
+            request.has_position = true;
+        }
+
+        if (root["items"]) {
+            if (!root["items"].IsSequence()) {
+                error = "items must be an array";
+                return false;
+            }
+
+            std::vector<MenuItem> items;
+            size_t budget = MAX_IPC_ITEMS;
+            for (const auto& node : root["items"]) {
+                MenuItem item;
+                if (!parse_ipc_item(node, 0, budget, item, error)) {
+                    return false;
+                }
+                items.push_back(item);
+            }
+
+            if (items.empty()) {
+                error = "items must not be empty";
+                return false;
+            }
+            request.items = std::move(items);
+        }
+    } catch (const YAML::Exception& e) {
+        error = std::string("malformed request: ") + e.what();
+        return false;
+    }
+
+    return true;
+}
+
+std::string IpcServer::format_reply(const MenuItem* selected) {
+    if (!selected) {
+        return "{\"id\": null}";
+    }
+    return "{\"id\": \"" + json_escape(selected->id.empty() ? selected->label : selected->id) + "\"}";
+}
+
+std::string IpcServer::format_error(const std::string& error) {
+    return "{\"error\": \"" + json_escape(error) + "\"}";
+}
+
+bool IpcServer::send_request(const std::string& line, std::string& reply,
+                             const std::string& socket_path) {
+    // The protocol is line based: fold a pretty-printed request onto one line
+    std::string request = line;
+    std::replace(request.begin(), request.end(), '\n', ' ');
+
+    try {
+        auto client = Gio::SocketClient::create();
+        auto connection = client->connect(Gio::UnixSocketAddress::create(socket_path));
+
+        gsize bytes_written = 0;
+        connection->get_output_stream()->write_all(request + "\n", bytes_written);
+
+        auto input = Gio::DataInputStream::create(connection->get_input_stream());
+        bool ok = input->read_line(reply);
+        connection->close();
+        return ok;
+    } catch (const Glib::Error& e) {
+        std::cerr << "IPC: " << socket_path << ": " << e.what() << "\n";
+        return false;
+    }
+}
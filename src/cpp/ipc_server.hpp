@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <giomm.h>
+#include "menu_item.hpp"
+
+// A menu pushed by another program over the daemon socket
+struct IpcMenuRequest {
+    std::optional<std::vector<MenuItem>> items;  // Unset: show the resident config menu
+    bool has_position = false;                   // Unset: show at the pointer
+    int x = 0;
+    int y = 0;
+};
+
+// Unix socket API of the resident (--daemon) instance
+// Protocol: one JSON object per line in, one JSON object per line out
+//   -> {"x": 500, "y": 300, "items": [{"id": "open", "label": "Open", "submenu": [...]}]}
+//   <- {"id": "open"}    or    {"id": null}    or    {"error": "..."}
+// Requests are parsed as YAML, of which JSON is a subset; other YAML that
+// happens to be accepted is not part of the protocol
+class IpcServer {
+public:
+    // Reply with the chosen item, or nullptr if the menu was dismissed
+    using ReplyFunc = std::function<void(const MenuItem* selected)>;
+    using RequestHandler = std::function<void(const IpcMenuRequest& request, const ReplyFunc& reply)>;
+
+    explicit IpcServer(const std::string& socket_path = default_socket_path());
+    ~IpcServer();
+
+    // Prevent copying
+    IpcServer(const IpcServer&) = delete;
+    IpcServer& operator=(const IpcServer&) = delete;
+
+    // False if the socket cannot be bound, or another daemon answers on it
+    bool start(const RequestHandler& handler);
+    void stop();
+
+    // $XDG_RUNTIME_DIR/radux.sock, or /tmp/radux-<uid>.sock
+    static std::string default_socket_path();
+
+    // Parse a request line; returns false and fills error on invalid input
+    static bool parse_request(const std::string& line, IpcMenuRequest& request, std::string& error);
+
+    // Build a reply line (without the trailing newline)
+    static std::string format_reply(const MenuItem* selected);
+    static std::string format_error(const std::string& error);
+
+    // Client side: send one request line and wait for the reply (used by --ipc)
+    static bool send_request(const std::string& line, std::string& reply,
+                             const std::string& socket_path = default_socket_path());
+
+private:
+    std::string socket_path_;
+    RequestHandler handler_;
+    Glib::RefPtr<Gio::SocketService> service_;
+
+    bool on_incoming(const Glib::RefPtr<Gio::SocketConnection>& connection,
+                     const Glib::RefPtr<Glib::Object>& source_object);
+};
@@ -1,5 +1,12 @@
 #include "radial_menu.hpp"
 #include "config_loader.hpp"
+#include "ipc_server.hpp"
+#include "menu_provider.hpp"
+#include "browse_provider.hpp"
+#include "recent_provider.hpp"
+#include "clipboard_history.hpp"
+#include "window_table.hpp"
+#include "memory_stats.hpp"
 #include <iostream>
 #include <memory>
 #include <cstdlib>
@@ -131,20 +138,21 @@ static int g_x = 0;
 static int g_y = 0;
 static RadialConfig g_config;
 static RadialMenu* g_window = nullptr;
+static bool g_daemon = false;
+static bool g_memory_report = false;
 
 class RadialApplication : public Gtk::Application {
 public:
-    RadialApplication() : Gtk::Application("com.github.raduxmenu", Gio::Application::Flags::NONE) {}
+    // The daemon registers under its own id so one-shot summons are not forwarded to it
+    RadialApplication()
+        : Gtk::Application(g_daemon ? "com.github.raduxmenu.daemon" : "com.github.raduxmenu",
+                           Gio::Application::Flags::NONE) {}
 
 protected:
     void on_activate() override {
-        // Get mouse position if coordinates not provided
-        if (g_x == 0 && g_y == 0) {
-            if (get_mouse_position(g_x, g_y)) {
-                std::cout << "Mouse position: " << g_x << ", " << g_y << "\n";
-            } else {
-                std::cerr << "Warning: Could not get mouse position, using screen center\n";
-            }
+        if (g_daemon) {
+            start_daemon();
+            return;
         }
 
         // Create the radial menu window (it's a Gtk::Window subclass)
@@ -157,31 +165,109 @@ protected:
         // Position and show
         if (g_x != 0 || g_y != 0) {
             g_window->present_at(g_x, g_y);
-        } else {
-            g_window->present();
+        } else if (!g_window->present_at_pointer()) {
+            // No in-process display access: fall back to xdotool
+            if (get_mouse_position(g_x, g_y)) {
+                std::cout << "Mouse position: " << g_x << ", " << g_y << "\n";
+                g_window->present_at(g_x, g_y);
+            } else {
+                std::cerr << "Warning: Could not get mouse position, using screen center\n";
+                g_window->present();
+            }
         }
     }
 
     void on_shutdown() override {
-        // Clean up PID file
-        std::remove(PID_FILE);
+        // Clean up PID file (the daemon never writes one)
+        if (!g_daemon) {
+            std::remove(PID_FILE);
+        }
+        ipc_server_.reset();
 
         delete g_window;
         g_window = nullptr;
         Gtk::Application::on_shutdown();
+
+        if (g_memory_report) {
+            MemoryStats::report(std::cerr);
+        }
     }
-};
 
-int main(int argc, char** argv) {
-    // Kill any existing radux-menu instance before starting
-    kill_existing_instance();
+private:
+    std::unique_ptr<IpcServer> ipc_server_;
+
+    void start_daemon() {
+        // Activated again by a second --daemon invocation: already serving
+        if (ipc_server_) {
+            return;
+        }
+
+        ipc_server_ = std::make_unique<IpcServer>();
+        if (!ipc_server_->start(sigc::mem_fun(*this, &RadialApplication::on_ipc_request))) {
+            ipc_server_.reset();
+            return;
+        }
+
+        // Clipboard history only makes sense in a process that stays around
+        auto clipboard = std::make_shared<ClipboardHistory>(
+            static_cast<size_t>(g_config.clipboard_entries),
+            static_cast<size_t>(g_config.clipboard_max_kb) * 1024);
+        if (clipboard->start()) {
+            ProviderRegistry::instance().add("clipboard", clipboard);
+        }
+
+        // Window list for raise-class items, kept current from here on
+        WindowTable::instance().start();
 
-    // Write our PID file
-    write_pid_file();
+        // Stay alive with no windows open
+        hold();
+    }
+
+    void on_ipc_request(const IpcMenuRequest& request, const IpcServer::ReplyFunc& reply) {
+        // One menu at a time: a new request dismisses the previous one (its caller gets null)
+        if (g_window) {
+            g_window->close();
+        }
 
+        // Pushed menus reuse the resident theme and geometry; nothing is read or validated from disk
+        RadialConfig config = g_config;
+        if (request.items) {
+            config.items = *request.items;
+        }
+
+        RadialMenu* window = new RadialMenu(config);
+        window->set_selection_handler(reply);
+        window->signal_hide().connect([window]() {
+            if (g_window == window) {
+                g_window = nullptr;
+            }
+            // Delete once GTK is done with the hide emission
+            Glib::signal_idle().connect_once([window]() {
+                delete window;
+
+                // What a summon leaves behind shows up as growth between reports
+                if (g_memory_report) {
+                    MemoryStats::report(std::cerr);
+                }
+            });
+        });
+
+        add_window(*window);
+        g_window = window;
+
+        if (request.has_position) {
+            window->present_at(request.x, request.y);
+        } else if (!window->present_at_pointer()) {
+            window->present();
+        }
+    }
+};
+
+int main(int argc, char** argv) {
     // Parse command line arguments
     std::string config_file;
     std::string cli_config;
+    std::string ipc_request;
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -190,6 +276,12 @@ int main(int argc, char** argv) {
             cli_config = argv[++i];
         } else if (arg == "--config" && i + 1 < argc) {
             config_file = argv[++i];
+        } else if (arg == "--daemon") {
+            g_daemon = true;
+        } else if (arg == "--ipc" && i + 1 < argc) {
+            ipc_request = argv[++i];
+        } else if (arg == "--memory-report") {
+            g_memory_report = true;
         } else if (arg == "--help" || arg == "-h") {
             std::cout << "Usage: " << argv[0] << " [x] [y] [OPTIONS]\n"
                       << "\n"
@@ -201,6 +293,9 @@ int main(int argc, char** argv) {
                       << "  --cli <config>    Override config with CLI string\n"
                       << "                    Format: \"title:description:action;title2:desc2:act2;...\"\n"
                       << "  --config <file>   Use custom YAML config file\n"
+                      << "  --daemon          Stay resident and serve menus on " << IpcServer::default_socket_path() << "\n"
+                      << "  --ipc <json>      Send a menu request to the daemon and print its reply\n"
+                      << "  --memory-report   Print heap use per subsystem on exit (and after each daemon menu)\n"
                       << "  --help, -h        Show this help message\n"
                       << "\n"
                       << "Config file search order:\n"
@@ -228,6 +323,26 @@ int main(int argc, char** argv) {
         }
     }
 
+    // IPC client: no window, no config, just one request/reply
+    if (!ipc_request.empty()) {
+        Gio::init();
+        std::string reply;
+        if (!IpcServer::send_request(ipc_request, reply)) {
+            return 1;
+        }
+        std::cout << reply << "\n";
+        return 0;
+    }
+
+    // Kill any existing radux-menu instance before starting
+    // (the daemon is long-lived and tracked by its socket instead)
+    if (!g_daemon) {
+        kill_existing_instance();
+
+        // Write our PID file
+        write_pid_file();
+    }
+
     // Load configuration
     if (!cli_config.empty()) {
         // CLI override takes priority
@@ -258,7 +373,22 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // Built-in providers, then plugins for dynamic submenus
+    ProviderRegistry::instance().add("browse", std::make_shared<BrowseProvider>(
+        g_config.browse_opener, g_config.browse_limit, g_config.browse_hidden));
+    ProviderRegistry::instance().add("recent", std::make_shared<RecentProvider>(
+        g_config.browse_opener, g_config.recent_limit));
+
+    const char* home = std::getenv("HOME");
+    if (home) {
+        ProviderRegistry::instance().load_plugins(std::string(home) + "/.config/radux/plugins");
+    }
+
     // Create and run application
     RadialApplication app;
-    return app.run(argc, argv);
+    int status = app.run(argc, argv);
+
+    // Fetches still running would keep worker threads busy while the process exits
+    ProviderRegistry::instance().cancel_all();
+    return status;
 }
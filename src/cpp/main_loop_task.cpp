@@ -0,0 +1,204 @@
+#include "main_loop_task.hpp"
+#include <glib-unix.h>
+#include <exception>
+#include <iostream>
+
+CancelScope::CancelScope()
+    : state_(std::make_shared<State>())
+{
+}
+
+CancelScope::~CancelScope() {
+    cancel();
+}
+
+CancelToken CancelScope::token() const {
+    return CancelToken(state_);
+}
+
+void CancelScope::cancel() {
+    if (state_->cancelled) {
+        return;
+    }
+    state_->cancelled = true;
+
+    // Destroying a frame unregisters its awaiter, so iterate over a detached copy
+    auto waiters = std::move(state_->waiters);
+    state_->waiters.clear();
+    for (auto& entry : waiters) {
+        entry.second();
+    }
+}
+
+void CancelScope::reset() {
+    cancel();
+    state_ = std::make_shared<State>();
+}
+
+size_t CancelToken::on_cancel(std::function<void()> callback) {
+    size_t id = state_->next_id++;
+    state_->waiters.emplace(id, std::move(callback));
+    return id;
+}
+
+void CancelToken::remove(size_t id) {
+    if (state_) {
+        state_->waiters.erase(id);
+    }
+}
+
+void Task::promise_type::unhandled_exception() noexcept {
+    // Nothing awaits a Task, so an escaping exception ends only that task
+    try {
+        throw;
+    } catch (const Glib::Error& e) {
+        std::cerr << "Task: Uncaught exception: " << e.what() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Task: Uncaught exception: " << e.what() << "\n";
+    } catch (...) {
+        std::cerr << "Task: Uncaught exception\n";
+    }
+}
+
+SourceAwaiter::~SourceAwaiter() {
+    detach();
+    if (cancel_id_ != 0) {
+        token_.remove(cancel_id_);
+    }
+}
+
+void SourceAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // Already cancelled: the frame (and this awaiter with it) goes away here
+    if (token_.is_cancelled()) {
+        handle.destroy();
+        return;
+    }
+
+    handle_ = handle;
+    source_id_ = attach();
+    cancel_id_ = token_.on_cancel([this]() {
+        cancel_id_ = 0;
+        handle_.destroy();
+    });
+}
+
+void SourceAwaiter::resume() {
+    // The firing source removes itself after its callback returns
+    source_id_ = 0;
+    token_.remove(cancel_id_);
+    cancel_id_ = 0;
+    handle_.resume();
+}
+
+bool SourceAwaiter::detach() {
+    if (source_id_ == 0) {
+        return false;
+    }
+    g_source_remove(source_id_);
+    source_id_ = 0;
+    return true;
+}
+
+guint TimerAwaiter::attach() {
+    return g_timeout_add(
+        milliseconds_,
+        [](gpointer data) -> gboolean {
+            static_cast<TimerAwaiter*>(data)->resume();
+            return G_SOURCE_REMOVE;
+        },
+        this
+    );
+}
+
+guint FdAwaiter::attach() {
+    return g_unix_fd_add(
+        fd_, condition_,
+        [](gint, GIOCondition condition, gpointer data) -> gboolean {
+            auto* self = static_cast<FdAwaiter*>(data);
+            self->result_ = condition;
+            self->resume();
+            return G_SOURCE_REMOVE;
+        },
+        this
+    );
+}
+
+ChildAwaiter::~ChildAwaiter() {
+    // Cancelled before the exit: still reap it so no zombie is left behind
+    if (detach()) {
+        g_child_watch_add(pid_, [](GPid pid, gint, gpointer) { g_spawn_close_pid(pid); }, nullptr);
+    }
+}
+
+guint ChildAwaiter::attach() {
+    return g_child_watch_add(
+        pid_,
+        [](GPid pid, gint status, gpointer data) {
+            auto* self = static_cast<ChildAwaiter*>(data);
+            g_spawn_close_pid(pid);
+            self->status_ = status;
+            self->resume();
+        },
+        this
+    );
+}
+
+DBusCallAwaiter::DBusCallAwaiter(CancelToken token, Call call)
+    : token_(std::move(token))
+    , call_(std::move(call))
+    , shared_(std::make_shared<Shared>())
+{
+}
+
+DBusCallAwaiter::~DBusCallAwaiter() {
+    shared_->awaiter = nullptr;
+    if (cancel_id_ != 0) {
+        token_.remove(cancel_id_);
+    }
+    if (cancellable_) {
+        cancellable_->cancel();
+    }
+}
+
+void DBusCallAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    if (token_.is_cancelled() || !call_.connection) {
+        handle.destroy();
+        return;
+    }
+
+    handle_ = handle;
+    shared_->awaiter = this;
+    cancellable_ = Gio::Cancellable::create();
+    cancel_id_ = token_.on_cancel([this]() {
+        cancel_id_ = 0;
+        handle_.destroy();
+    });
+
+    auto connection = call_.connection;
+    auto shared = shared_;
+    connection->call(
+        call_.object_path, call_.interface_name, call_.method_name, call_.parameters,
+        [connection, shared](Glib::RefPtr<Gio::AsyncResult>& result) {
+            DBusReply reply;
+            try {
+                reply.value = connection->call_finish(result);
+                reply.ok = true;
+            } catch (const Glib::Error& e) {
+                reply.error = e.what();
+            }
+            // A cancelled task's call completes with an error nobody reads
+            if (shared->awaiter) {
+                shared->awaiter->finish(std::move(reply));
+            }
+        },
+        cancellable_, call_.bus_name, call_.timeout_ms
+    );
+}
+
+void DBusCallAwaiter::finish(DBusReply reply) {
+    reply_ = std::move(reply);
+    cancellable_.reset();
+    token_.remove(cancel_id_);
+    cancel_id_ = 0;
+    handle_.resume();
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <glib.h>
+#include <giomm.h>
+#include "worker_pool.hpp"
+
+// Coroutines on the GLib main loop
+// A Task starts immediately and runs on the GTK thread; every co_await
+// below suspends it on a GLib source and resumes it from the main loop, so
+// callback chains (timer -> spawn -> wait -> read) read as sequential code.
+// Each await takes a CancelToken: cancelling its CancelScope removes the
+// pending source and destroys the suspended coroutine without resuming it,
+// so a scope owned by a window or menu level bounds every task started on it
+
+class CancelToken;
+
+// Owner side of a cancellation: cancelled on destruction or cancel()
+class CancelScope {
+public:
+    CancelScope();
+    ~CancelScope();
+
+    // Prevent copying
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+
+    CancelToken token() const;
+
+    // Drop every task suspended on this scope
+    void cancel();
+
+    // cancel(), then accept new tasks
+    void reset();
+
+    struct State {
+        bool cancelled = false;
+        size_t next_id = 1;
+        std::unordered_map<size_t, std::function<void()>> waiters;
+    };
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+// Handed to awaits; cheap to copy, keeps no coroutine alive
+class CancelToken {
+public:
+    CancelToken() = default;
+
+    bool is_cancelled() const { return !state_ || state_->cancelled; }
+
+    // Register/unregister a callback run when the scope is cancelled
+    size_t on_cancel(std::function<void()> callback);
+    void remove(size_t id);
+
+private:
+    friend class CancelScope;
+    explicit CancelToken(std::shared_ptr<CancelScope::State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<CancelScope::State> state_;
+};
+
+// Fire-and-forget coroutine: runs until its first await, frees itself when done
+// Parameters must be taken by value; the caller's references do not outlive the first await
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+    };
+};
+
+// Common part of awaits that wait for one GLib source to fire
+class SourceAwaiter {
+public:
+    explicit SourceAwaiter(CancelToken token) : token_(std::move(token)) {}
+    virtual ~SourceAwaiter();
+
+    // Prevent copying
+    SourceAwaiter(const SourceAwaiter&) = delete;
+    SourceAwaiter& operator=(const SourceAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+
+protected:
+    // Create the source; its callback calls resume() and lets the source go
+    virtual guint attach() = 0;
+    void resume();
+
+    // Remove a still pending source; true if there was one
+    bool detach();
+
+private:
+    CancelToken token_;
+    std::coroutine_handle<> handle_;
+    guint source_id_ = 0;
+    size_t cancel_id_ = 0;
+};
+
+class TimerAwaiter : public SourceAwaiter {
+public:
+    TimerAwaiter(CancelToken token, guint milliseconds)
+        : SourceAwaiter(std::move(token)), milliseconds_(milliseconds) {}
+    void await_resume() const noexcept {}
+
+private:
+    guint attach() override;
+    guint milliseconds_;
+};
+
+class FdAwaiter : public SourceAwaiter {
+public:
+    FdAwaiter(CancelToken token, int fd, GIOCondition condition)
+        : SourceAwaiter(std::move(token)), fd_(fd), condition_(condition) {}
+    GIOCondition await_resume() const noexcept { return result_; }
+
+private:
+    guint attach() override;
+    int fd_;
+    GIOCondition condition_;
+    GIOCondition result_ = static_cast<GIOCondition>(0);
+};
+
+class ChildAwaiter : public SourceAwaiter {
+public:
+    ChildAwaiter(CancelToken token, GPid pid)
+        : SourceAwaiter(std::move(token)), pid_(pid) {}
+    ~ChildAwaiter() override;
+    int await_resume() const noexcept { return status_; }
+
+private:
+    guint attach() override;
+    GPid pid_;
+    int status_ = 0;
+};
+
+// Resume after a delay
+inline TimerAwaiter sleep_for(CancelToken token, guint milliseconds) {
+    return TimerAwaiter(std::move(token), milliseconds);
+}
+
+// Resume once fd is readable (or hung up); yields the triggering condition
+inline FdAwaiter wait_readable(CancelToken token, int fd) {
+    return FdAwaiter(std::move(token), fd, static_cast<GIOCondition>(G_IO_IN | G_IO_HUP | G_IO_ERR));
+}
+
+// Resume once a child spawned with G_SPAWN_DO_NOT_REAP_CHILD exits; yields its wait status
+// The pid is reaped either way, also when the task is cancelled first
+inline ChildAwaiter wait_child(CancelToken token, GPid pid) {
+    return ChildAwaiter(std::move(token), pid);
+}
+
+// Run a function on the WorkerPool and resume with its result on the GTK thread
+// A cancelled task still lets the job finish; its result is dropped. An
+// exception thrown by the job is rethrown from the co_await
+template <typename T>
+class WorkerAwaiter {
+public:
+    WorkerAwaiter(CancelToken token, std::function<T()> job)
+        : token_(std::move(token)), job_(std::move(job)), shared_(std::make_shared<Shared>()) {}
+
+    ~WorkerAwaiter() {
+        shared_->awaiter = nullptr;
+        if (cancel_id_ != 0) {
+            token_.remove(cancel_id_);
+        }
+    }
+
+    // Prevent copying
+    WorkerAwaiter(const WorkerAwaiter&) = delete;
+    WorkerAwaiter& operator=(const WorkerAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        if (token_.is_cancelled()) {
+            handle.destroy();
+            return;
+        }
+
+        handle_ = handle;
+        shared_->awaiter = this;
+        cancel_id_ = token_.on_cancel([this]() {
+            cancel_id_ = 0;
+            handle_.destroy();
+        });
+
+        WorkerPool::instance().submit([shared = shared_, job = std::move(job_)]() {
+            // The task resumes either way; a job that escaped here would leave it suspended
+            std::optional<T> value;
+            std::exception_ptr error;
+            try {
+                value = job();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            WorkerPool::run_on_main([shared, value = std::move(value), error]() mutable {
+                if (shared->awaiter) {
+                    shared->awaiter->finish(std::move(value), error);
+                }
+            });
+        });
+    }
+
+    T await_resume() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return std::move(*result_);
+    }
+
+private:
+    struct Shared {
+        WorkerAwaiter* awaiter = nullptr;  // Cleared once the awaiting frame is gone
+    };
+
+    void finish(std::optional<T> value, std::exception_ptr error) {
+        result_ = std::move(value);
+        error_ = error;
+        token_.remove(cancel_id_);
+        cancel_id_ = 0;
+        handle_.resume();
+    }
+
+    CancelToken token_;
+    std::function<T()> job_;
+    std::shared_ptr<Shared> shared_;
+    std::coroutine_handle<> handle_;
+    std::optional<T> result_;
+    std::exception_ptr error_;
+    size_t cancel_id_ = 0;
+};
+
+template <typename Fn>
+WorkerAwaiter<std::invoke_result_t<Fn>> run_in_worker(CancelToken token, Fn job) {
+    static_assert(!std::is_void_v<std::invoke_result_t<Fn>>, "worker jobs must return a value");
+    return WorkerAwaiter<std::invoke_result_t<Fn>>(std::move(token), std::move(job));
+}
+
+// Outcome of a D-Bus method call
+struct DBusReply {
+    bool ok = false;
+    Glib::VariantContainerBase value;  // Reply arguments when ok
+    std::string error;                 // Error message otherwise
+};
+
+// Call a D-Bus method asynchronously and resume with the reply
+// Cancelling the task also cancels the call
+class DBusCallAwaiter {
+public:
+    struct Call {
+        Glib::RefPtr<Gio::DBus::Connection> connection;
+        std::string bus_name;
+        std::string object_path;
+        std::string interface_name;
+        std::string method_name;
+        Glib::VariantContainerBase parameters;
+        int timeout_ms = -1;  // -1: the bus default
+    };
+
+    DBusCallAwaiter(CancelToken token, Call call);
+    ~DBusCallAwaiter();
+
+    // Prevent copying
+    DBusCallAwaiter(const DBusCallAwaiter&) = delete;
+    DBusCallAwaiter& operator=(const DBusCallAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    DBusReply await_resume() { return std::move(reply_); }
+
+private:
+    struct Shared {
+        DBusCallAwaiter* awaiter = nullptr;
+    };
+
+    void finish(DBusReply reply);
+
+    CancelToken token_;
+    Call call_;
+    std::shared_ptr<Shared> shared_;
+    Glib::RefPtr<Gio::Cancellable> cancellable_;
+    std::coroutine_handle<> handle_;
+    DBusReply reply_;
+    size_t cancel_id_ = 0;
+};
+
+inline DBusCallAwaiter dbus_call(CancelToken token, DBusCallAwaiter::Call call) {
+    return DBusCallAwaiter(std::move(token), std::move(call));
+}
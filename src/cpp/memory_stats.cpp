@@ -0,0 +1,167 @@
+#include "memory_stats.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static const char* const TAG_NAMES[] = {
+    "other", "yaml", "config", "menus", "providers", "caches", "usage"
+};
+static_assert(sizeof(TAG_NAMES) / sizeof(TAG_NAMES[0]) == static_cast<size_t>(MemoryTag::Count),
+              "every tag needs a name");
+
+#ifdef RADUX_MEMORY_STATS
+
+static const size_t TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+// Plain arrays of lock-free atomics: usable before any constructor has run
+static std::atomic<int64_t> g_current[TAG_COUNT];
+static std::atomic<int64_t> g_peak[TAG_COUNT];
+
+static thread_local MemoryTag t_tag = MemoryTag::Other;
+
+// Stored in front of every block so a free knows its size and tag
+struct alignas(16) BlockHeader {
+    size_t size;
+    uint32_t tag;
+    uint32_t offset;  // From the start of the malloc'd block to the user pointer
+};
+static_assert(sizeof(BlockHeader) == 16, "header must keep malloc's alignment");
+
+static void charge(MemoryTag tag, int64_t bytes) {
+    auto index = static_cast<size_t>(tag);
+    int64_t now = g_current[index].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = g_peak[index].load(std::memory_order_relaxed);
+    while (now > peak && !g_peak[index].compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+static void* tracked_alloc(size_t size, size_t alignment) {
+    size_t offset = alignment > sizeof(BlockHeader) ? alignment : sizeof(BlockHeader);
+    void* raw;
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc wants a multiple of the alignment
+        size_t total = (size + offset + alignment - 1) / alignment * alignment;
+        raw = std::aligned_alloc(alignment, total);
+    } else {
+        raw = std::malloc(size + offset);
+    }
+    if (!raw) {
+        return nullptr;
+    }
+
+    char* user = static_cast<char*>(raw) + offset;
+    auto* header = reinterpret_cast<BlockHeader*>(user) - 1;
+    header->size = size;
+    header->tag = static_cast<uint32_t>(t_tag);
+    header->offset = static_cast<uint32_t>(offset);
+    charge(t_tag, static_cast<int64_t>(size));
+    return user;
+}
+
+static void tracked_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    auto* header = static_cast<BlockHeader*>(ptr) - 1;
+    charge(static_cast<MemoryTag>(header->tag), -static_cast<int64_t>(header->size));
+    std::free(static_cast<char*>(ptr) - header->offset);
+}
+
+static void* tracked_new(size_t size, size_t alignment) {
+    void* ptr = tracked_alloc(size == 0 ? 1 : size, alignment);
+    while (!ptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+        ptr = tracked_alloc(size == 0 ? 1 : size, alignment);
+    }
+    return ptr;
+}
+
+void* operator new(size_t size) { return tracked_new(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return tracked_new(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t align) { return tracked_new(size, static_cast<size_t>(align)); }
+void* operator new[](size_t size, std::align_val_t align) { return tracked_new(size, static_cast<size_t>(align)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return tracked_alloc(size == 0 ? 1 : size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return tracked_alloc(size == 0 ? 1 : size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return tracked_alloc(size == 0 ? 1 : size, static_cast<size_t>(align));
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return tracked_alloc(size == 0 ? 1 : size, static_cast<size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+
+MemoryScope::MemoryScope(MemoryTag tag)
+    : previous_(t_tag)
+{
+    t_tag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    t_tag = previous_;
+}
+
+bool MemoryStats::enabled() {
+    return true;
+}
+
+int64_t MemoryStats::current(MemoryTag tag) {
+    return g_current[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+}
+
+int64_t MemoryStats::peak(MemoryTag tag) {
+    return g_peak[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+}
+
+#else
+
+bool MemoryStats::enabled() {
+    return false;
+}
+
+int64_t MemoryStats::current(MemoryTag) {
+    return 0;
+}
+
+int64_t MemoryStats::peak(MemoryTag) {
+    return 0;
+}
+
+#endif
+
+void MemoryStats::report(std::ostream& out) {
+    if (!enabled()) {
+        out << "Memory: Built without RADUX_MEMORY_STATS\n";
+        return;
+    }
+
+    out << "Heap by subsystem (KiB)     current       peak\n";
+    for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i) {
+        auto tag = static_cast<MemoryTag>(i);
+        char line[80];
+        std::snprintf(line, sizeof(line), "  %-20s %12.1f %10.1f\n", TAG_NAMES[i],
+                      current(tag) / 1024.0, peak(tag) / 1024.0);
+        out << line;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Heap accounting per subsystem (built with -DRADUX_MEMORY_STATS=ON)
+// Global operator new/delete charge every C++ allocation to the subsystem
+// tagged on the allocating thread; frees are credited back to the same tag
+// wherever they happen. GLib/GDK allocations (g_malloc, pixbuf data) are
+// outside operator new and not counted
+
+enum class MemoryTag : uint8_t {
+    Other,       // Untagged
+    Yaml,        // YAML DOM while a config file is parsed
+    Config,      // RadialConfig model built from it
+    Menus,       // Menu stack levels of an open window
+    Providers,   // Provider fetches on worker threads
+    Caches,      // Provider results and icon cache
+    Usage,       // Usage store
+    Count
+};
+
+#ifdef RADUX_MEMORY_STATS
+
+// Charges this thread's allocations to a tag until it goes out of scope (nests)
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+
+    // Prevent copying
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous_;
+};
+
+#else
+
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag) {}
+};
+
+#endif
+
+class MemoryStats {
+public:
+    // Compiled with the allocator hooks
+    static bool enabled();
+
+    // Live bytes and high-water mark per tag (0 without the hooks)
+    static int64_t current(MemoryTag tag);
+    static int64_t peak(MemoryTag tag);
+
+    // Table of every tag: current and peak
+    static void report(std::ostream& out);
+};
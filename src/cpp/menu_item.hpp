@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <functional>
 #include "color_theme.hpp"
 
 struct MenuItem {
@@ -12,14 +13,33 @@ struct MenuItem {
     std::string command;
     std::vector<MenuItem> submenu;
 
+    // Application started by .desktop ID (D-Bus activation when supported)
+    // command, if also set, replaces the app's Exec line when spawning
+    std::string desktop_id;
+
+    // WM_CLASS of a window to activate instead, when one is open (run-or-raise)
+    std::string raise_class;
+
     // Visual enhancements
-    std::optional<std::string> icon;           // Path to .svg file
+    std::optional<std::string> icon;           // Path to .svg file, or icon theme name
     std::optional<Theme> theme_override;       // Custom colors for this item
     int priority = 0;                          // 0-10, affects button size
+    bool label_with_icon = false;              // Draw the label under the icon
 
     // Interaction
     std::optional<std::string> hotkey;         // e.g., "Ctrl+1"
     bool notify = false;                       // Send stdout to notify-send
+    int cache_ttl = 0;                         // Seconds notify output is reused (0: always run)
+
+    // Identifier reported back to IPC clients (defaults to label)
+    std::string id;
+
+    // Dynamic submenu filled by a provider when opened
+    std::string provider;                      // Registered provider name
+    std::string provider_arg;                  // Passed to the provider as-is
+
+    // In-process action run instead of a command (built-in providers only)
+    std::function<void()> action;
 
     // Default constructor
     MenuItem() = default;
@@ -53,6 +73,21 @@ struct MenuItem {
         return !submenu.empty();
     }
 
+    // Check if this item opens a provider-filled submenu
+    bool is_dynamic() const {
+        return !provider.empty();
+    }
+
+    // Check if activating this item navigates instead of executing
+    bool opens_submenu() const {
+        return has_submenu() || is_dynamic();
+    }
+
+    // Check if activating this item starts something
+    bool launches() const {
+        return !command.empty() || !desktop_id.empty();
+    }
+
     // Check if this is a valid item
     bool is_valid() const {
         return !label.empty();
@@ -0,0 +1,391 @@
+#include "menu_provider.hpp"
+#include "worker_pool.hpp"
+#include "memory_stats.hpp"
+#include "radux_plugin.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <dlfcn.h>
+
+// ProviderRequest
+
+bool ProviderRequest::emit(MenuItem item) {
+    if (cancelled_) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(item));
+    }
+    schedule_flush();
+    return true;
+}
+
+void ProviderRequest::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    schedule_flush();
+}
+
+void ProviderRequest::schedule_flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (flush_scheduled_) {
+            return;  // Items emitted meanwhile ride along with the pending flush
+        }
+        flush_scheduled_ = true;
+    }
+
+    WorkerPool::run_on_main([self = shared_from_this()]() { self->flush(); });
+}
+
+void ProviderRequest::flush() {
+    std::vector<MenuItem> batch;
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.swap(pending_);
+        finished = finished_;
+        flush_scheduled_ = false;
+    }
+
+    if (!batch.empty()) {
+        delivered_.insert(delivered_.end(), batch.begin(), batch.end());
+        if (!cancelled_ && on_items_) {
+            on_items_(batch);
+        }
+    }
+
+    if (finished && !done_) {
+        done_ = true;
+        if (!cancelled_) {
+            if (on_complete_) {
+                on_complete_(delivered_);
+            }
+            if (on_done_) {
+                on_done_();
+            }
+        }
+    }
+}
+
+void ProviderRequest::subscribe(const ItemsCallback& on_items, const DoneCallback& on_done) {
+    on_items_ = on_items;
+    on_done_ = on_done;
+
+    if (!delivered_.empty() && on_items_) {
+        on_items_(delivered_);
+    }
+    if (done_ && on_done_) {
+        on_done_();
+    }
+}
+
+void ProviderRequest::cancel() {
+    cancelled_ = true;
+    on_items_ = nullptr;
+    on_done_ = nullptr;
+
+    // Completion is skipped once cancelled; the registry is told here instead
+    if (auto on_cancel = std::move(on_cancel_)) {
+        on_cancel_ = nullptr;
+        on_cancel();
+    }
+}
+
+// Plugin adapter
+
+// The C handle only wraps the C++ request
+struct radux_request {
+    ProviderRequest* request;
+};
+
+static int host_emit(radux_request* handle, const radux_item* item) {
+    if (!handle) {
+        return 0;
+    }
+    if (!item || !item->label) {
+        return handle->request->is_cancelled() ? 0 : 1;
+    }
+
+    MenuItem menu_item;
+    menu_item.label = item->label;
+    menu_item.command = item->command ? item->command : "";
+    menu_item.description = item->description ? item->description : "";
+    if (item->icon) {
+        menu_item.icon = std::string(item->icon);
+    }
+    if (item->hotkey) {
+        menu_item.hotkey = std::string(item->hotkey);
+    }
+    menu_item.provider = item->provider ? item->provider : "";
+    menu_item.provider_arg = item->provider_arg ? item->provider_arg : "";
+    menu_item.priority = std::clamp(item->priority, 0, 10);
+
+    return handle->request->emit(std::move(menu_item)) ? 1 : 0;
+}
+
+static int host_is_cancelled(const radux_request* handle) {
+    return !handle || handle->request->is_cancelled() ? 1 : 0;
+}
+
+static const radux_host_api HOST_API = {
+    RADUX_PLUGIN_ABI_VERSION,
+    host_emit,
+    host_is_cancelled
+};
+
+class PluginProvider : public MenuProvider {
+public:
+    explicit PluginProvider(const radux_provider* provider)
+        : provider_(provider)
+        , state_(provider->init ? provider->init(&HOST_API) : nullptr)
+    {}
+
+    ~PluginProvider() override {
+        if (provider_->shutdown) {
+            provider_->shutdown(state_);
+        }
+        // The library stays loaded: a worker may still be returning from fetch()
+    }
+
+    ProviderCachePolicy cache_policy() const override {
+        ProviderCachePolicy policy;
+        switch (provider_->cache_mode) {
+            case RADUX_CACHE_SESSION:
+                policy.mode = ProviderCacheMode::Session;
+                break;
+            case RADUX_CACHE_TTL:
+                policy.mode = ProviderCacheMode::Ttl;
+                policy.ttl_ms = static_cast<int>(provider_->cache_ttl_ms);
+                break;
+            default:
+                policy.mode = ProviderCacheMode::None;
+                break;
+        }
+        return policy;
+    }
+
+    void fetch(const std::string& arg, ProviderRequest& request) override {
+        radux_request handle{&request};
+        provider_->fetch(state_, &HOST_API, &handle, arg.c_str());
+    }
+
+private:
+    const radux_provider* provider_;
+    void* state_;
+};
+
+// ProviderRegistry
+
+std::string ProviderRegistry::cache_key(const std::string& name, const std::string& arg) {
+    return name + '\0' + arg;
+}
+
+void ProviderRegistry::add(const std::string& name, std::shared_ptr<MenuProvider> provider) {
+    providers_[name] = std::move(provider);
+}
+
+bool ProviderRegistry::has(const std::string& name) const {
+    return providers_.count(name) > 0;
+}
+
+void ProviderRegistry::load_plugins(const std::string& directory) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(directory, ec)) {
+        return;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() != ".so") {
+            continue;
+        }
+
+        std::string path = entry.path().string();
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            std::cerr << "Plugin: Failed to load " << path << ": " << dlerror() << "\n";
+            continue;
+        }
+
+        auto entry_fn = reinterpret_cast<radux_plugin_entry_fn>(dlsym(handle, RADUX_PLUGIN_ENTRY));
+        const radux_provider* provider = entry_fn ? entry_fn() : nullptr;
+
+        if (!provider || provider->abi_version != RADUX_PLUGIN_ABI_VERSION ||
+            !provider->name || !provider->fetch) {
+            std::cerr << "Plugin: " << path << " is not a compatible radux provider (ABI "
+                      << RADUX_PLUGIN_ABI_VERSION << " expected)\n";
+            dlclose(handle);
+            continue;
+        }
+
+        if (has(provider->name)) {
+            std::cerr << "Plugin: Provider '" << provider->name << "' already registered, skipping "
+                      << path << "\n";
+            dlclose(handle);
+            continue;
+        }
+
+        add(provider->name, std::make_shared<PluginProvider>(provider));
+        std::cerr << "Plugin: Loaded provider '" << provider->name << "' from " << path << "\n";
+    }
+}
+
+bool ProviderRegistry::lookup_cache(const std::string& key, const ProviderCachePolicy& policy,
+                                    std::vector<MenuItem>& items) const {
+    if (policy.mode == ProviderCacheMode::None) {
+        return false;
+    }
+
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+        return false;
+    }
+
+    if (policy.mode == ProviderCacheMode::Ttl) {
+        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - it->second.stored
+        ).count();
+        if (age >= policy.ttl_ms) {
+            return false;
+        }
+    }
+
+    items = it->second.items;
+    return true;
+}
+
+std::shared_ptr<ProviderRequest> ProviderRegistry::request(const std::string& name,
+                                                           const std::string& arg) {
+    auto request = std::make_shared<ProviderRequest>();
+    request->provider_ = name;
+    request->arg_ = arg;
+    std::string key = cache_key(name, arg);
+
+    auto provider_it = providers_.find(name);
+    if (provider_it == providers_.end()) {
+        std::cerr << "Unknown provider '" << name << "'\n";
+        request->done_ = true;
+        return request;
+    }
+
+    std::shared_ptr<MenuProvider> provider = provider_it->second;
+    ProviderCachePolicy policy = provider->cache_policy();
+
+    // Fresh cached items: answer without touching a worker
+    std::vector<MenuItem> cached;
+    if (lookup_cache(key, policy, cached)) {
+        request->delivered_ = std::move(cached);
+        request->done_ = true;
+        return request;
+    }
+
+    // Join a fetch that is already running (e.g. a hover prefetch)
+    auto inflight_it = inflight_.find(key);
+    if (inflight_it != inflight_.end()) {
+        auto running = inflight_it->second.lock();
+        if (running && !running->is_cancelled() && !running->is_subscribed()) {
+            return running;
+        }
+    }
+
+    request->on_complete_ = [this, key, policy, weak = std::weak_ptr<ProviderRequest>(request)](
+                                const std::vector<MenuItem>& items) {
+        auto self = weak.lock();
+        forget_inflight(key, self.get());
+        if (policy.mode != ProviderCacheMode::None && self && self->cacheable_) {
+            MemoryScope memory(MemoryTag::Caches);
+            cache_[key] = CacheEntry{items, std::chrono::steady_clock::now()};
+        }
+    };
+    request->on_cancel_ = [this, key, raw = request.get()]() { forget_inflight(key, raw); };
+    inflight_[key] = request;
+
+    WorkerPool::instance().submit([provider, arg, request]() {
+        if (!request->is_cancelled()) {
+            MemoryScope memory(MemoryTag::Providers);
+            provider->fetch(arg, *request);
+        }
+        request->finish();
+    });
+
+    return request;
+}
+
+void ProviderRegistry::prefetch(const std::string& name, const std::string& arg) {
+    auto provider_it = providers_.find(name);
+    if (provider_it == providers_.end() ||
+        provider_it->second->cache_policy().mode == ProviderCacheMode::None) {
+        return;
+    }
+
+    // The request keeps itself alive until it completes and fills the cache
+    request(name, arg);
+}
+
+void ProviderRegistry::invalidate(const std::string& name, const std::string& arg) {
+    std::string key = cache_key(name, arg);
+    cache_.erase(key);
+
+    // A fetch still running may have read the old data: show it, but don't keep it
+    auto inflight_it = inflight_.find(key);
+    if (inflight_it != inflight_.end()) {
+        if (auto running = inflight_it->second.lock()) {
+            running->set_cacheable(false);
+        }
+    }
+}
+
+void ProviderRegistry::forget_inflight(const std::string& key, const ProviderRequest* request) {
+    // A newer fetch of the same key may have taken the slot
+    auto it = inflight_.find(key);
+    if (it != inflight_.end() && it->second.lock().get() == request) {
+        inflight_.erase(it);
+    }
+}
+
+void ProviderRegistry::cancel_all() {
+    // Copied: cancelling removes entries
+    std::vector<std::shared_ptr<ProviderRequest>> running;
+    for (const auto& [key, weak] : inflight_) {
+        if (auto request = weak.lock()) {
+            running.push_back(request);
+        }
+    }
+    for (const auto& request : running) {
+        request->cancel();
+    }
+    inflight_.clear();
+}
+
+void ProviderRegistry::refresh(const std::string& name) {
+    std::string prefix = cache_key(name, "");
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        it = it->first.compare(0, prefix.size(), prefix) == 0 ? cache_.erase(it) : std::next(it);
+    }
+    for (const auto& [key, weak] : inflight_) {
+        auto running = weak.lock();
+        if (running && key.compare(0, prefix.size(), prefix) == 0) {
+            running->set_cacheable(false);
+        }
+    }
+
+    // Copied: a listener may remove itself
+    auto listeners = listeners_;
+    for (const auto& [id, listener] : listeners) {
+        listener(name);
+    }
+}
+
+int ProviderRegistry::add_change_listener(const ChangeListener& listener) {
+    int id = next_listener_++;
+    listeners_[id] = listener;
+    return id;
+}
+
+void ProviderRegistry::remove_change_listener(int id) {
+    listeners_.erase(id);
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include "menu_item.hpp"
+
+// How long a provider's items may be reused
+enum class ProviderCacheMode {
+    None,     // Fetch every time the submenu opens
+    Session,  // Fetch once per process (until invalidated)
+    Ttl       // Reuse for ttl_ms milliseconds
+};
+
+struct ProviderCachePolicy {
+    ProviderCacheMode mode = ProviderCacheMode::None;
+    int ttl_ms = 0;
+};
+
+// One running fetch, shared between a worker thread and the GTK thread
+// The worker emits items; they are batched and delivered on the GTK thread
+class ProviderRequest : public std::enable_shared_from_this<ProviderRequest> {
+public:
+    using ItemsCallback = std::function<void(const std::vector<MenuItem>& batch)>;
+    using DoneCallback = std::function<void()>;
+
+    // Worker thread: hand over one item (returns false once cancelled)
+    bool emit(MenuItem item);
+    bool is_cancelled() const { return cancelled_; }
+
+    // Worker thread: keep this result out of the cache (e.g. it cannot be kept fresh)
+    void set_cacheable(bool cacheable) { cacheable_ = cacheable; }
+
+    // GTK thread: items delivered so far are replayed synchronously
+    void subscribe(const ItemsCallback& on_items, const DoneCallback& on_done);
+    bool is_subscribed() const { return static_cast<bool>(on_items_); }
+    void cancel();
+    bool is_done() const { return done_; }
+    const std::vector<MenuItem>& items() const { return delivered_; }
+
+    // What this request fetches
+    const std::string& provider() const { return provider_; }
+    const std::string& arg() const { return arg_; }
+
+private:
+    friend class ProviderRegistry;
+
+    std::string provider_;
+    std::string arg_;
+
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> cacheable_{true};
+
+    // Shared with the worker (guarded by mutex_)
+    std::mutex mutex_;
+    std::vector<MenuItem> pending_;
+    bool flush_scheduled_ = false;
+    bool finished_ = false;
+
+    // GTK thread only
+    std::vector<MenuItem> delivered_;
+    bool done_ = false;
+    ItemsCallback on_items_;
+    DoneCallback on_done_;
+    std::function<void(const std::vector<MenuItem>& items)> on_complete_;
+    std::function<void()> on_cancel_;
+
+    void schedule_flush();
+    void flush();
+    void finish();
+};
+
+// Source of submenu items computed when the submenu is opened
+class MenuProvider {
+public:
+    virtual ~MenuProvider() = default;
+
+    virtual ProviderCachePolicy cache_policy() const { return {}; }
+
+    // Runs on a worker thread: emit items through request.emit() and return
+    // when done, or as soon as request.is_cancelled() becomes true
+    virtual void fetch(const std::string& arg, ProviderRequest& request) = 0;
+};
+
+// Named providers (built-in and plugins) plus the cache of their results
+// All methods are called on the GTK thread
+class ProviderRegistry {
+public:
+    static ProviderRegistry& instance() {
+        static ProviderRegistry inst;
+        return inst;
+    }
+
+    // Prevent copying
+    ProviderRegistry(const ProviderRegistry&) = delete;
+    ProviderRegistry& operator=(const ProviderRegistry&) = delete;
+
+    void add(const std::string& name, std::shared_ptr<MenuProvider> provider);
+    bool has(const std::string& name) const;
+
+    // Load every *.so provider plugin from a directory
+    void load_plugins(const std::string& directory);
+
+    // Start (or join, or answer from cache) a fetch; subscribe to receive items
+    std::shared_ptr<ProviderRequest> request(const std::string& name, const std::string& arg);
+
+    // Warm the cache without showing anything (no-op for uncached providers)
+    void prefetch(const std::string& name, const std::string& arg);
+
+    // Drop cached items, e.g. when the underlying data changed
+    void invalidate(const std::string& name, const std::string& arg);
+
+    // Cancel every fetch still running, so providers that watch for it return
+    // (before exit: the worker pool only waits a moment for busy threads)
+    void cancel_all();
+
+    // Drop every cached result of a provider and tell the listeners, so open
+    // menus fetch again (for providers that answer from stale data first and
+    // finish an update in the background)
+    void refresh(const std::string& name);
+
+    // Listeners get the provider name passed to refresh()
+    using ChangeListener = std::function<void(const std::string& name)>;
+    int add_change_listener(const ChangeListener& listener);
+    void remove_change_listener(int id);
+
+private:
+    ProviderRegistry() = default;
+
+    struct CacheEntry {
+        std::vector<MenuItem> items;
+        std::chrono::steady_clock::time_point stored;
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<MenuProvider>> providers_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::unordered_map<std::string, std::weak_ptr<ProviderRequest>> inflight_;
+    std::unordered_map<int, ChangeListener> listeners_;
+    int next_listener_ = 0;
+
+    static std::string cache_key(const std::string& name, const std::string& arg);
+    void forget_inflight(const std::string& key, const ProviderRequest* request);
+    bool lookup_cache(const std::string& key, const ProviderCachePolicy& policy,
+                      std::vector<MenuItem>& items) const;
+};
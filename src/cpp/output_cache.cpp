@@ -0,0 +1,330 @@
+#include "output_cache.hpp"
+#include "shell_Utilities.hpp"
+#include "text_Utilities.hpp"
+#include <glib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Output kept per command (the notification shows far less)
+static const size_t MAX_OUTPUT_BYTES = 64 * 1024;
+
+// Entries kept on disk: at most this many, none older than this (the
+// directory then stays under MAX_ENTRIES * MAX_OUTPUT_BYTES plus keys)
+static const size_t MAX_ENTRIES = 256;
+static const int64_t MAX_ENTRY_AGE_SECONDS = 30 * 24 * 60 * 60;
+
+// A ".tmp" file this old was left by a writer that died
+static const int64_t MAX_TEMP_AGE_SECONDS = 60;
+
+// Notification body limit
+static const size_t MAX_NOTIFY_CHARS = 500;
+
+// Center preview: lines and characters per line
+static const int PREVIEW_LINES = 3;
+static const size_t PREVIEW_LINE_CHARS = 40;
+
+// Environment that changes what a command prints (part of the cache key)
+static const char* const KEY_ENVIRONMENT[] = {
+    "PATH", "HOME", "USER", "LANG", "LC_ALL", "DISPLAY", "WAYLAND_DISPLAY"
+};
+
+OutputCache::OutputCache() {
+    const char* cache_home = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if (cache_home && cache_home[0] != '\0') {
+        directory_ = std::string(cache_home) + "/radux/output";
+    } else if (home) {
+        directory_ = std::string(home) + "/.cache/radux/output";
+    }
+}
+
+std::string OutputCache::key_for(const std::string& command) const {
+    std::string key = command;
+    for (const char* name : KEY_ENVIRONMENT) {
+        const char* value = std::getenv(name);
+        key += '\0';
+        key += name;
+        key += '=';
+        key += value ? value : "";
+    }
+    return key;
+}
+
+std::string OutputCache::path_for(const std::string& key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016zx", std::hash<std::string>{}(key));
+    return directory_ + "/" + name;
+}
+
+const OutputCache::Entry* OutputCache::lookup(const std::string& command) {
+    std::string key = key_for(command);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        Entry entry;
+        std::optional<Entry> loaded;
+        if (!directory_.empty() && load(path_for(key), key, entry)) {
+            loaded = std::move(entry);
+        }
+        it = entries_.emplace(key, std::move(loaded)).first;
+    }
+    return it->second ? &*it->second : nullptr;
+}
+
+const OutputCache::Entry* OutputCache::cached(const std::string& command) const {
+    auto it = entries_.find(key_for(command));
+    return it != entries_.end() && it->second ? &*it->second : nullptr;
+}
+
+void OutputCache::preload(CancelToken token, const std::string& command, std::function<void()> on_loaded) {
+    std::string key = key_for(command);
+    if (directory_.empty() || entries_.count(key) || !loading_.insert(key).second) {
+        return;
+    }
+    load_in_worker(std::move(token), key, std::move(on_loaded));
+}
+
+Task OutputCache::load_in_worker(CancelToken token, std::string key, std::function<void()> on_loaded) {
+    // Undone however the task ends, so a cancelled load can be asked for again
+    struct Loading {
+        OutputCache* cache;
+        std::string key;
+
+        ~Loading() {
+            cache->loading_.erase(key);
+        }
+    } loading{this, key};
+
+    auto read = [path = path_for(key), key]() {
+        Entry entry;
+        return load(path, key, entry) ? std::optional<Entry>(std::move(entry)) : std::nullopt;
+    };
+    std::optional<Entry> loaded = co_await run_in_worker(token, read);
+
+    // A refresh that finished meanwhile has the newer output
+    auto it = entries_.emplace(key, std::move(loaded)).first;
+    if (it->second && on_loaded) {
+        on_loaded();
+    }
+}
+
+void OutputCache::run(const std::string& label, const std::string& command, int ttl_seconds) {
+    const Entry* entry = lookup(command);
+    if (entry && !entry->output.empty()) {
+        send_notification(label, entry->output);
+    }
+
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    std::string key = key_for(command);
+    if ((entry && now - entry->time < ttl_seconds) || refreshing_.count(key)) {
+        return;
+    }
+
+    // Nothing cached yet: the notification waits for the command instead
+    refreshing_.insert(key);
+    refresh(tasks_.token(), key, label, command, !entry);
+}
+
+Task OutputCache::refresh(CancelToken token, std::string key, std::string label, std::string command,
+                          bool notify) {
+    // Undone however the task ends; the hold keeps a one-shot instance alive until then
+    struct Running {
+        OutputCache* cache;
+        std::string key;
+        Glib::RefPtr<Gio::Application> app;
+        int fd = -1;
+
+        ~Running() {
+            cache->refreshing_.erase(key);
+            if (fd >= 0) {
+                close(fd);
+            }
+            if (app) {
+                app->release();
+            }
+        }
+    } running{this, key, Gio::Application::get_default()};
+    if (running.app) {
+        running.app->hold();
+    }
+
+    // Same parsing as a plain notify item (no shell)
+    GPid pid = 0;
+    try {
+        std::vector<std::string> argv = Glib::shell_parse_argv(command);
+        Glib::spawn_async_with_pipes("", argv,
+                                     Glib::SpawnFlags::SEARCH_PATH | Glib::SpawnFlags::DO_NOT_REAP_CHILD,
+                                     {}, &pid, nullptr, &running.fd, nullptr);
+    } catch (const Glib::Error& e) {
+        std::cerr << "Failed to execute command: " << e.what() << "\n";
+        co_return;
+    }
+
+    fcntl(running.fd, F_SETFL, fcntl(running.fd, F_GETFL) | O_NONBLOCK);
+    std::string output;
+    char buffer[4096];
+    bool reading = true;
+    while (reading) {
+        co_await wait_readable(token, running.fd);
+        while (true) {
+            ssize_t bytes = read(running.fd, buffer, sizeof(buffer));
+            if (bytes > 0) {
+                size_t room = MAX_OUTPUT_BYTES - std::min(output.size(), MAX_OUTPUT_BYTES);
+                output.append(buffer, std::min(static_cast<size_t>(bytes), room));
+            } else if (bytes < 0 && errno == EINTR) {
+                continue;
+            } else {
+                reading = bytes < 0 && errno == EAGAIN;
+                break;
+            }
+        }
+    }
+
+    int status = co_await wait_child(token, pid);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "Command failed with exit code "
+                  << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << ": " << command << "\n";
+        co_return;
+    }
+
+    // Written on the worker pool, which also scans the directory for old entries
+    Entry entry{output, static_cast<int64_t>(std::time(nullptr))};
+    auto write = [this, key, entry]() {
+        store(key, entry);
+        return true;
+    };
+    co_await run_in_worker(token, write);
+    entries_[key] = std::move(entry);
+
+    if (notify && !output.empty()) {
+        send_notification(label, output);
+    }
+}
+
+bool OutputCache::load(const std::string& path, const std::string& key, Entry& entry) {
+    gchar* contents = nullptr;
+    gsize length = 0;
+    if (!g_file_get_contents(path.c_str(), &contents, &length, nullptr)) {
+        return false;
+    }
+    std::string data(contents, length);
+    g_free(contents);
+
+    // "<time> <key length>\n<key><output>"; a different key means a hash collision
+    size_t header = data.find('\n');
+    long long time = 0;
+    size_t key_length = 0;
+    if (header == std::string::npos ||
+        std::sscanf(data.substr(0, header).c_str(), "%lld %zu", &time, &key_length) != 2) {
+        return false;
+    }
+    ++header;
+    if (data.size() - header < key_length || data.compare(header, key_length, key) != 0) {
+        return false;
+    }
+
+    entry.time = time;
+    entry.output = data.substr(header + key_length);
+    return true;
+}
+
+void OutputCache::store(const std::string& key, const Entry& entry) const {
+    if (directory_.empty() || g_mkdir_with_parents(directory_.c_str(), 0700) != 0) {
+        return;
+    }
+
+    // Written aside and renamed, so a reader never sees half an entry
+    std::string path = path_for(key);
+    std::string temp = path + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return;
+    }
+
+    std::string data = std::to_string(entry.time) + " " + std::to_string(key.size()) + "\n" + key + entry.output;
+    bool ok = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        std::cerr << "Output cache: Cannot write " << path << "\n";
+        unlink(temp.c_str());
+    }
+
+    prune();
+}
+
+void OutputCache::prune() const {
+    DIR* handle = opendir(directory_.c_str());
+    if (!handle) {
+        return;
+    }
+
+    // Only names this cache writes: 16 hex digits, ".tmp" while being written
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    std::vector<std::pair<int64_t, std::string>> entries;  // (mtime, path)
+    while (dirent* file = readdir(handle)) {
+        std::string name = file->d_name;
+        bool temp = name.size() == 20 && name.compare(16, 4, ".tmp") == 0;
+        if ((name.size() != 16 && !temp) || name.find_first_not_of("0123456789abcdef") < 16) {
+            continue;
+        }
+        std::string path = directory_ + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            continue;
+        }
+        int64_t age = now - static_cast<int64_t>(info.st_mtime);
+        if (age > (temp ? MAX_TEMP_AGE_SECONDS : MAX_ENTRY_AGE_SECONDS)) {
+            unlink(path.c_str());
+        } else if (!temp) {
+            entries.emplace_back(static_cast<int64_t>(info.st_mtime), path);
+        }
+    }
+    closedir(handle);
+
+    // Past the limit, the least recently refreshed go first
+    if (entries.size() > MAX_ENTRIES) {
+        std::sort(entries.begin(), entries.end());
+        for (size_t i = 0; i < entries.size() - MAX_ENTRIES; ++i) {
+            unlink(entries[i].second.c_str());
+        }
+    }
+}
+
+void OutputCache::send_notification(const std::string& title, const std::string& body) {
+    // SECURITY: Use proper escaping for notification
+    std::string notify_cmd = "notify-send " + ShellEscaper::escape_notify_arg(title) + " " +
+                             ShellEscaper::escape_notify_arg(Utf8Text::truncate(body, MAX_NOTIFY_CHARS));
+    try {
+        Glib::spawn_command_line_async(notify_cmd);
+    } catch (const Glib::SpawnError& e) {
+        std::cerr << "Failed to execute command: " << e.what() << "\n";
+    }
+}
+
+std::string OutputCache::preview(const std::string& output) {
+    std::string result;
+    size_t start = 0;
+    for (int line = 0; line < PREVIEW_LINES && start < output.size(); ++line) {
+        size_t end = output.find('\n', start);
+        std::string text = output.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (!result.empty()) {
+            result += "\n";
+        }
+        result += Utf8Text::truncate(text, PREVIEW_LINE_CHARS);
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return result;
+}
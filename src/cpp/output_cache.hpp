@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "main_loop_task.hpp"
+
+// Remembered stdout of "notify" items that set cache-ttl
+// A repeated click is answered from the last output at once; a missing or
+// stale entry is refreshed by running the command in the background. Entries
+// are keyed by command plus the environment it sees, and kept under
+// ~/.cache/radux/output so one-shot instances share them
+class OutputCache {
+public:
+    static OutputCache& instance() {
+        static OutputCache inst;
+        return inst;
+    }
+
+    // Prevent copying
+    OutputCache(const OutputCache&) = delete;
+    OutputCache& operator=(const OutputCache&) = delete;
+
+    struct Entry {
+        std::string output;
+        int64_t time = 0;  // When the command last ran (Unix seconds)
+    };
+
+    // GTK thread: last output of command (memory first, then disk); nullptr if none
+    const Entry* lookup(const std::string& command);
+
+    // GTK thread, for painting: the entry if it is already in memory; never reads the disk
+    const Entry* cached(const std::string& command) const;
+
+    // GTK thread: read the entry of command from disk on the worker pool;
+    // on_loaded runs once it is in memory (not if there is none, or once token is cancelled)
+    void preload(CancelToken token, const std::string& command, std::function<void()> on_loaded);
+
+    // GTK thread: notify with the cached output, running the command first if
+    // nothing is cached and again in the background once older than ttl_seconds
+    void run(const std::string& label, const std::string& command, int ttl_seconds);
+
+    // Desktop notification with a command's output as body
+    static void send_notification(const std::string& title, const std::string& body);
+
+    // First lines of an output, shortened for the menu center
+    static std::string preview(const std::string& output);
+
+private:
+    OutputCache();
+
+    Task refresh(CancelToken token, std::string key, std::string label, std::string command, bool notify);
+    Task load_in_worker(CancelToken token, std::string key, std::function<void()> on_loaded);
+
+    std::string key_for(const std::string& command) const;
+    std::string path_for(const std::string& key) const;
+    static bool load(const std::string& path, const std::string& key, Entry& entry);
+
+    // Worker thread: write an entry, then drop old ones from the directory
+    void store(const std::string& key, const Entry& entry) const;
+    void prune() const;
+
+    std::string directory_;
+
+    // By key; nullopt: looked for, nothing on disk
+    std::unordered_map<std::string, std::optional<Entry>> entries_;
+
+    // Keys being read from disk
+    std::unordered_set<std::string> loading_;
+
+    // Keys whose command is running
+    std::unordered_set<std::string> refreshing_;
+
+    // Refreshes in flight (process lifetime)
+    CancelScope tasks_;
+};
@@ -8,6 +8,14 @@
 // X11 headers (only included when needed)
 #ifdef HAS_X11
 #include <X11/Xlib.h>
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+#ifdef HAS_XCB_RANDR
+#include <xcb/randr.h>
+#endif
+#ifdef GDK_WINDOWING_X11
+#include <gdk/x11/gdkx.h>
+#endif
 #endif
 
 // Check if we're running on Wayland
@@ -26,28 +34,62 @@ static bool detect_wayland() {
     return false;
 }
 
+// Check if the X server is reached over the network
+// ":0" and "unix:0" use the local socket; any other host (including the
+// "localhost:10.0" that SSH X forwarding sets up) goes through TCP
+static bool detect_remote_display() {
+    const char* display = g_getenv("DISPLAY");
+    if (!display || display[0] == '\0') {
+        return false;
+    }
+
+    std::string name = display;
+    size_t colon = name.rfind(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    std::string host = name.substr(0, colon);
+    if (host.empty() || host == "unix" || host[0] == '/') {
+        return false;
+    }
+
+    return true;
+}
+
 // X11 Backend Implementation
 #ifdef HAS_X11
 
-#include <X11/Xlib.h>
 #include <stdexcept>
+#include <cstdlib>
 
 struct X11DisplayWrapper {
     Display* display_;
+    bool owns_display_;
 
-    X11DisplayWrapper() : display_(nullptr) {
-        display_ = XOpenDisplay(nullptr);
+    explicit X11DisplayWrapper(Display* borrowed) : display_(borrowed), owns_display_(false) {
+        if (!display_) {
+            display_ = XOpenDisplay(nullptr);
+            owns_display_ = true;
+        }
         if (!display_) {
             throw std::runtime_error("Failed to open X11 display");
         }
+
+#ifdef HAS_XCB_RANDR
+        // Ask for the RandR extension data now so the reply is already cached
+        // by the time the first monitor query needs it
+        xcb_prefetch_extension_data(connection(), &xcb_randr_id);
+#endif
     }
 
     ~X11DisplayWrapper() {
-        if (display_) {
+        if (display_ && owns_display_) {
             XCloseDisplay(display_);
         }
     }
 
+    xcb_connection_t* connection() const { return XGetXCBConnection(display_); }
     int screen() const { return DefaultScreen(display_); }
     Window root_window() const { return RootWindow(display_, screen()); }
 
@@ -70,14 +112,83 @@ struct X11DisplayWrapper {
         x = root_x;
         y = root_y;
     }
-};
 
-X11DisplayBackend::X11DisplayBackend() {
-    try {
-        display_ = nullptr;
-    } catch (...) {
-        display_ = nullptr;
+    bool query_screen_state(bool want_pointer, int& x, int& y,
+                            std::vector<MonitorGeometry>& monitors) {
+        xcb_connection_t* conn = connection();
+        xcb_window_t root = static_cast<xcb_window_t>(root_window());
+
+        // Issue every request before waiting on any reply, so they share one round trip
+        xcb_query_pointer_cookie_t pointer_cookie = {};
+        if (want_pointer) {
+            pointer_cookie = xcb_query_pointer(conn, root);
+        }
+
+#ifdef HAS_XCB_RANDR
+        const xcb_query_extension_reply_t* randr = xcb_get_extension_data(conn, &xcb_randr_id);
+        bool has_randr = randr && randr->present;
+        xcb_randr_get_monitors_cookie_t monitors_cookie = {};
+        if (has_randr) {
+            monitors_cookie = xcb_randr_get_monitors(conn, root, 1);
+        }
+#endif
+
+        bool pointer_ok = !want_pointer;
+        xcb_generic_error_t* error = nullptr;
+
+        if (want_pointer) {
+            xcb_query_pointer_reply_t* reply = xcb_query_pointer_reply(conn, pointer_cookie, &error);
+            if (reply) {
+                x = reply->root_x;
+                y = reply->root_y;
+                pointer_ok = true;
+                free(reply);
+            }
+            free(error);
+            error = nullptr;
+        }
+
+#ifdef HAS_XCB_RANDR
+        if (has_randr) {
+            xcb_randr_get_monitors_reply_t* reply =
+                xcb_randr_get_monitors_reply(conn, monitors_cookie, &error);
+            if (reply) {
+                xcb_randr_monitor_info_iterator_t it = xcb_randr_get_monitors_monitors_iterator(reply);
+                for (; it.rem; xcb_randr_monitor_info_next(&it)) {
+                    MonitorGeometry monitor;
+                    monitor.x = it.data->x;
+                    monitor.y = it.data->y;
+                    monitor.width = it.data->width;
+                    monitor.height = it.data->height;
+                    monitors.push_back(monitor);
+                }
+                free(reply);
+            }
+            free(error);
+        }
+#endif
+
+        // No RandR 1.5: treat the whole screen as one monitor (known from setup, no round trip)
+        if (monitors.empty()) {
+            MonitorGeometry monitor;
+            get_screen_geometry(monitor.width, monitor.height);
+            monitors.push_back(monitor);
+        }
+
+        return pointer_ok;
     }
+
+    void move_window(Window xid, int x, int y) {
+        XMoveWindow(display_, xid, x, y);
+        XFlush(display_);
+    }
+};
+
+X11DisplayBackend::X11DisplayBackend(void* borrowed_display)
+    : display_(nullptr), borrowed_display_(borrowed_display) {
+    // Set up now, so the RandR prefetch is answered before the first summon
+    // instead of costing it an extra round trip
+    ensure_display();
 }
 
 X11DisplayBackend::~X11DisplayBackend() {
@@ -86,62 +197,90 @@ X11DisplayBackend::~X11DisplayBackend() {
     }
 }
 
-bool X11DisplayBackend::get_screen_geometry(int& width, int& height) {
+bool X11DisplayBackend::ensure_display() {
     if (!display_) {
         try {
-            display_ = new X11DisplayWrapper();
+            display_ = new X11DisplayWrapper(static_cast<Display*>(borrowed_display_));
         } catch (...) {
             return false;
         }
     }
+    return true;
+}
+
+bool X11DisplayBackend::get_screen_geometry(int& width, int& height) {
+    if (!ensure_display()) {
+        return false;
+    }
     static_cast<X11DisplayWrapper*>(display_)->get_screen_geometry(width, height);
     return true;
 }
 
 bool X11DisplayBackend::get_pointer_position(int& x, int& y) {
-    if (!display_) {
-        try {
-            display_ = new X11DisplayWrapper();
-        } catch (...) {
-            return false;
-        }
+    if (!ensure_display()) {
+        return false;
     }
     static_cast<X11DisplayWrapper*>(display_)->get_pointer_position(x, y);
     return true;
 }
 
 bool X11DisplayBackend::warp_pointer(int x, int y) {
-    if (!display_) {
-        try {
-            display_ = new X11DisplayWrapper();
-        } catch (...) {
-            return false;
-        }
+    if (!ensure_display()) {
+        return false;
     }
     static_cast<X11DisplayWrapper*>(display_)->warp_pointer(x, y);
     return true;
 }
 
+bool X11DisplayBackend::query_screen_state(bool want_pointer, int& x, int& y,
+                                           std::vector<MonitorGeometry>& monitors) {
+    if (!ensure_display()) {
+        return false;
+    }
+    return static_cast<X11DisplayWrapper*>(display_)->query_screen_state(want_pointer, x, y, monitors);
+}
+
+bool X11DisplayBackend::move_window(unsigned long xid, int x, int y) {
+    if (!ensure_display()) {
+        return false;
+    }
+    static_cast<X11DisplayWrapper*>(display_)->move_window(static_cast<Window>(xid), x, y);
+    return true;
+}
+
 #else // !HAS_X11
 
-X11DisplayBackend::X11DisplayBackend() : display_(nullptr) {}
+X11DisplayBackend::X11DisplayBackend(void*) : display_(nullptr), borrowed_display_(nullptr) {}
 X11DisplayBackend::~X11DisplayBackend() {}
+bool X11DisplayBackend::ensure_display() { return false; }
 bool X11DisplayBackend::get_screen_geometry(int&, int&) { return false; }
 bool X11DisplayBackend::get_pointer_position(int&, int&) { return false; }
 bool X11DisplayBackend::warp_pointer(int, int) { return false; }
+bool X11DisplayBackend::query_screen_state(bool, int&, int&, std::vector<MonitorGeometry>&) { return false; }
+bool X11DisplayBackend::move_window(unsigned long, int, int) { return false; }
 
 #endif // HAS_X11
 
 // PlatformDisplay Implementation
 PlatformDisplay::PlatformDisplay()
-    : is_wayland_(false), gdk_display_(nullptr) {
+    : is_wayland_(false), is_remote_(false), gdk_display_(nullptr) {
     // Detect Wayland
     is_wayland_ = detect_wayland();
+    gdk_display_ = gdk_display_get_default();
 
     // Only initialize X11 backend if not on Wayland
     if (!is_wayland_) {
+        is_remote_ = detect_remote_display();
 #ifdef HAS_X11
-        x11_backend_ = std::make_unique<X11DisplayBackend>();
+        // Reuse GDK's connection when GTK runs on X11 instead of opening another one
+        void* borrowed = nullptr;
+#ifdef GDK_WINDOWING_X11
+        GdkDisplay* display = static_cast<GdkDisplay*>(gdk_display_);
+        if (display && GDK_IS_X11_DISPLAY(display)) {
+            borrowed = gdk_x11_display_get_xdisplay(display);
+        }
+#endif
+        x11_backend_ = std::make_unique<X11DisplayBackend>(borrowed);
 #endif
     }
 }
@@ -196,7 +335,12 @@ bool PlatformDisplay::get_screen_geometry(int& width, int& height) const {
 }
 
 bool PlatformDisplay::get_pointer_position(int& x, int& y) const {
-    // Try xdotool first (simple, works on X11)
+    // Try the X11 backend first (one round trip, no process spawn)
+    if (x11_backend_ && x11_backend_->get_pointer_position(x, y)) {
+        return true;
+    }
+
+    // Fallback: xdotool
     FILE* pipe = popen("/usr/bin/xdotool getmouselocation --shell 2>/dev/null", "r");
     if (pipe) {
         char buffer[256];
@@ -212,11 +356,6 @@ bool PlatformDisplay::get_pointer_position(int& x, int& y) const {
         pclose(pipe);
     }
 
-    // Fallback: X11 backend
-    if (x11_backend_) {
-        return x11_backend_->get_pointer_position(x, y);
-    }
-
     return false;
 }
 
@@ -233,3 +372,60 @@ bool PlatformDisplay::warp_pointer(int x, int y) {
 
     return false;
 }
+
+// Pick the monitor containing (x, y), or the first one if none does
+static MonitorGeometry pick_monitor(const std::vector<MonitorGeometry>& monitors, int x, int y) {
+    for (const auto& monitor : monitors) {
+        if (monitor.contains(x, y)) {
+            return monitor;
+        }
+    }
+    return monitors.front();
+}
+
+bool PlatformDisplay::query_pointer_and_monitor(int& x, int& y, MonitorGeometry& monitor) const {
+    if (!x11_backend_) {
+        return false;
+    }
+
+    std::vector<MonitorGeometry> monitors;
+    if (!x11_backend_->query_screen_state(true, x, y, monitors) || monitors.empty()) {
+        return false;
+    }
+
+    monitor = pick_monitor(monitors, x, y);
+    return true;
+}
+
+bool PlatformDisplay::get_monitor_at(int x, int y, MonitorGeometry& monitor) const {
+    if (!x11_backend_) {
+        return false;
+    }
+
+    int unused_x = 0, unused_y = 0;
+    std::vector<MonitorGeometry> monitors;
+    if (!x11_backend_->query_screen_state(false, unused_x, unused_y, monitors) || monitors.empty()) {
+        return false;
+    }
+
+    monitor = pick_monitor(monitors, x, y);
+    return true;
+}
+
+bool PlatformDisplay::move_surface(void* gdk_surface, int x, int y) {
+    if (is_wayland_ || !x11_backend_ || !gdk_surface) {
+        return false;
+    }
+
+#if defined(HAS_X11) && defined(GDK_WINDOWING_X11)
+    GdkSurface* surface = static_cast<GdkSurface*>(gdk_surface);
+    if (!GDK_IS_X11_SURFACE(surface)) {
+        return false;
+    }
+    return x11_backend_->move_window(gdk_x11_surface_get_xid(surface), x, y);
+#else
+    (void)x;
+    (void)y;
+    return false;
+#endif
+}
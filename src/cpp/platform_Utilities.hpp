@@ -3,6 +3,19 @@
 #include <string>
 #include <optional>
 #include <memory>
+#include <vector>
+
+// Monitor geometry in root window (global) coordinates
+struct MonitorGeometry {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool contains(int px, int py) const {
+        return px >= x && px < x + width && py >= y && py < y + height;
+    }
+};
 
 // Platform abstraction layer for display operations
 // Works on both X11 and Wayland via GTK4/GDK APIs
@@ -25,11 +38,24 @@ public:
     // Note: Wayland does not allow applications to warp the pointer for security reasons
     bool warp_pointer(int x, int y);
 
+    // Get pointer position and the monitor containing it in a single round trip (X11 only)
+    bool query_pointer_and_monitor(int& x, int& y, MonitorGeometry& monitor) const;
+
+    // Get the monitor containing (x, y) in a single round trip (X11 only)
+    bool get_monitor_at(int x, int y, MonitorGeometry& monitor) const;
+
+    // Move a toplevel GdkSurface to global coordinates without waiting for a reply (X11 only)
+    bool move_surface(void* gdk_surface, int x, int y);
+
     // Check if running on Wayland
     bool is_wayland() const { return is_wayland_; }
 
+    // Check if the X server is reached over the network (SSH forwarding, thin clients)
+    bool is_remote() const { return is_remote_; }
+
 private:
     bool is_wayland_;
+    bool is_remote_;
     void* gdk_display_;  // GdkDisplay* (opaque to avoid including GDK headers in header file)
 
     // X11-specific (only used when not on Wayland)
@@ -37,15 +63,26 @@ private:
 };
 
 // X11 backend implementation (only used on X11)
+// Borrows GDK's Xlib connection when GTK runs on X11, so queries never open a second connection
 class X11DisplayBackend {
 public:
-    X11DisplayBackend();
+    explicit X11DisplayBackend(void* borrowed_display = nullptr);
     ~X11DisplayBackend();
 
     bool get_screen_geometry(int& width, int& height);
     bool get_pointer_position(int& x, int& y);
     bool warp_pointer(int x, int y);
 
+    // Pipelines the pointer and monitor queries so both replies arrive in one round trip
+    bool query_screen_state(bool want_pointer, int& x, int& y,
+                            std::vector<MonitorGeometry>& monitors);
+
+    // Fire-and-forget window move (no reply is awaited)
+    bool move_window(unsigned long xid, int x, int y);
+
 private:
-    void* display_;  // Display*
+    void* display_;           // X11DisplayWrapper*
+    void* borrowed_display_;  // Display* owned by GDK, if any
+
+    bool ensure_display();
 };
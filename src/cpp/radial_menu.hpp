@@ -4,13 +4,22 @@
 #include <cmath>
 #include <chrono>
 #include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <array>
+#include <utility>
 #include "menu_item.hpp"
 #include "config_loader.hpp"
 #include "color_theme.hpp"
+#include "platform_Utilities.hpp"
+#include "segment_area.hpp"
+#include "main_loop_task.hpp"
+#include "frame_scheduler.hpp"
 
 // Forward declarations
 class HotkeyManager;
 class UsageTracker;
+class ProviderRequest;
 
 class RadialMenu : public Gtk::Window {
 public:
@@ -20,6 +29,20 @@ public:
     // Show menu at specific screen coordinates
     void present_at(int x, int y);
 
+    // Show menu at the pointer (pointer and monitor fetched in one round trip)
+    // Returns false if the display cannot be queried in-process
+    bool present_at_pointer();
+
+    // Called once with the chosen leaf item, or nullptr if the menu closed without a choice
+    using SelectionHandler = std::function<void(const MenuItem* item)>;
+    void set_selection_handler(const SelectionHandler& handler);
+
+    // Drawing benchmark (bench/radial_menu_bench.cpp)
+    friend class RadialMenuBench;
+
+    // Icon loading test (tests/menu_icon_test.cpp)
+    friend class MenuIconProbe;
+
 private:
     // Configuration
     RadialConfig config_;
@@ -31,11 +54,31 @@ private:
     std::vector<MenuItem>* current_items_;
     int hovered_button_ = -1;
 
+    // Provider fetch feeding each stack level (nullptr for static levels)
+    std::vector<std::shared_ptr<ProviderRequest>> level_requests_;
+
+    // ProviderRegistry listener that refetches levels with newer items
+    int provider_listener_ = -1;
+
+    // Dwell-then-prefetch task for the hovered dynamic item (reset on hover change)
+    CancelScope hover_tasks_;
+
     // Track current menu path for usage tracking
     std::vector<std::string> current_menu_path_;
 
+    // Breadcrumb ring: one arc per ancestor level (-1: none hovered)
+    int hovered_crumb_ = -1;
+
+    // Selection reporting (IPC menus)
+    SelectionHandler selection_handler_;
+    bool selection_reported_ = false;
+
     // GTK widgets
-    Gtk::DrawingArea area_;
+    SegmentArea area_;
+
+    // Display queries and remote-session handling
+    std::unique_ptr<PlatformDisplay> platform_;
+    bool remote_mode_ = false;
 
     // Animation state
     double animation_progress_ = 0.0;
@@ -50,7 +93,23 @@ private:
 
     // Auto-close timer
     std::chrono::steady_clock::time_point last_activity_;
-    guint auto_close_timeout_id_ = 0;
+
+    // Tasks living as long as the window
+    CancelScope window_tasks_;
+
+    // Decoded icons by path or theme name, with the copies scaled for drawing
+    static const int THEME_ICON_SIZE = 48;
+    struct CachedIcon {
+        Glib::RefPtr<Gdk::Pixbuf> pixbuf;                // null: not found
+        std::vector<Glib::RefPtr<Gdk::Pixbuf>> scaled;   // One per size drawn
+    };
+    std::unordered_map<std::string, CachedIcon> icon_cache_;
+
+    // Icons waiting for frame slack, by the most urgent priority asked for
+    std::unordered_map<std::string, SlackPriority> icon_queued_;
+
+    // Icons being decoded on the worker pool
+    std::unordered_set<std::string> icon_pending_;
 
     // Input systems (will be initialized when implemented)
     std::unique_ptr<HotkeyManager> hotkey_manager_;
@@ -70,18 +129,56 @@ private:
     std::pair<double, double> get_center() const;
     int get_button_at_pos(double x, double y) const;
     double get_button_radius(int index) const;
+    void get_button_arc(int index, int total, double& inner_r, double& outer_r,
+                        double& start, double& end) const;
+    Gdk::Rectangle get_part_bounds(int part) const;
+    bool show_breadcrumbs() const;
+    void get_breadcrumb_ring(double& inner_r, double& outer_r) const;
+    int get_crumb_at_pos(double x, double y) const;
 
     // Easing functions for smooth animations
     static double ease_out_cubic(double t);
     static double ease_out_back(double t);
     static double ease_out_elastic(double t);
 
+    // Button rendering, specialized on the features a level uses
+    enum RenderFeature : unsigned {
+        RENDER_ICONS = 1 << 0,
+        RENDER_HINTS = 1 << 1,
+        RENDER_OVERRIDES = 1 << 2,   // Per-item theme colors
+        RENDER_PRIORITY = 1 << 3,    // Priority-sized wedges
+        RENDER_WIPE = 1 << 4,        // Radial wipe clip (opening animation)
+        RENDER_ANALYTIC = 1 << 5,    // Wedges through sector_raster instead of Cairo paths
+        RENDER_COMBINATIONS = 1 << 6
+    };
+    using ButtonsRenderer = void (RadialMenu::*)(const Cairo::RefPtr<Cairo::Context>& cr,
+                                                 double cx, double cy, int first, int last);
+
+    // Chosen when the level changes (select_renderer), with and without the wipe
+    ButtonsRenderer draw_buttons_ = nullptr;
+    ButtonsRenderer draw_buttons_wipe_ = nullptr;
+
+    void select_renderer();
+    static ButtonsRenderer renderer_for(unsigned features);
+    template <size_t... Features>
+    static std::array<ButtonsRenderer, sizeof...(Features)>
+    make_renderer_table(std::index_sequence<Features...>);
+
     // Drawing helpers
+    template <unsigned Features>
+    void draw_buttons(const Cairo::RefPtr<Cairo::Context>& cr,
+                      double cx, double cy, int first, int last);
+    template <unsigned Features>
     void draw_button(const Cairo::RefPtr<Cairo::Context>& cr,
                      int index, int total,
                      double cx, double cy);
     void draw_center(const Cairo::RefPtr<Cairo::Context>& cr,
                      double cx, double cy);
+    void draw_part(const Cairo::RefPtr<Cairo::Context>& cr, int part);
+    void draw_placeholder(const Cairo::RefPtr<Cairo::Context>& cr,
+                          double cx, double cy);
+    void draw_breadcrumbs(const Cairo::RefPtr<Cairo::Context>& cr,
+                          double cx, double cy);
     void draw_text(const Cairo::RefPtr<Cairo::Context>& cr,
                    double x, double y, const std::string& text,
                    int font_size = 14, bool bold = true);
@@ -89,12 +186,45 @@ private:
                              double cx, double cy, const std::string& text);
     bool draw_icon(const Cairo::RefPtr<Cairo::Context>& cr,
                    double x, double y, const std::string& icon_path, double size);
-    bool load_icon_from_file(const std::string& icon_path,
-                            Glib::RefPtr<Gdk::Pixbuf>& pixbuf);
+    Glib::RefPtr<Gdk::Pixbuf> scaled_icon(const std::string& icon_path, double size);
+    std::string lookup_theme_icon(const std::string& name);
+    std::string back_icon_path() const;
+
+    // Icons are looked up in frame slack and decoded on the worker pool; each
+    // segment is redrawn as its icon arrives
+    void request_level_icons();
+    void request_icon(const std::string& icon_path, SlackPriority priority);
+    void resolve_icon(const std::string& icon_path);
+    Task decode_icon(CancelToken token, std::string icon_path, std::string file_path, int size);
+    void redraw_icon(const std::string& icon_path);
+
+    // Kept outputs of cached notify items are read on the worker pool too;
+    // the center is redrawn as one arrives
+    void request_level_outputs();
 
     // Menu navigation
     void push_menu(const std::vector<MenuItem>& submenu, const std::string& label = "");
+    void push_dynamic_menu(const MenuItem& item);
     void pop_menu();
+    void pop_to_level(size_t depth);
+    void activate_item(const MenuItem& item);
+
+    // Provider results streaming into a level
+    void on_level_items(size_t depth, const std::vector<MenuItem>& batch);
+    void on_provider_changed(const std::string& provider);
+    void replace_level(size_t depth, const std::vector<MenuItem>& items);
+    void refresh_level();
+
+    // Window placement
+    void present_on_monitor(int x, int y, const MonitorGeometry& monitor);
+
+    // Redraw only what a hover change touched (menu at rest) or everything
+    void redraw_hover_change(int old_hover, int new_hover);
+
+    // Warm the provider cache once the pointer rests on a dynamic item
+    void schedule_hover_prefetch();
+    Task prefetch_after_dwell(CancelToken token, std::string provider, std::string arg);
+    void update_segments();
 
     // Setup
     void setup_window();
@@ -103,6 +233,7 @@ private:
 
     // Command execution
     void execute_command(const MenuItem& item);
+    void report_selection(const MenuItem* item);
 
     // Animations
     void start_open_animation();
@@ -110,5 +241,5 @@ private:
 
     // Activity tracking for auto-close
     void reset_activity_timer();
-    bool on_auto_close_timeout();
+    Task auto_close_when_idle(CancelToken token);
 };
@@ -0,0 +1,93 @@
+/*
+ * Radux provider plugin ABI
+ *
+ * A provider is a shared object in ~/.config/radux/plugins that fills a
+ * submenu with items at the moment the user opens it. Reference it from the
+ * config with:
+ *
+ *   - label: "Windows"
+ *     provider: "windows"        # radux_provider.name
+ *     provider-arg: "current"    # passed to fetch() as-is (optional)
+ *
+ * fetch() runs on a worker thread. Items are streamed through host->emit()
+ * and shown as they arrive, so a slow provider never blocks navigation. When
+ * the user leaves the level the request is cancelled: emit() returns 0 and
+ * is_cancelled() returns 1, and fetch() should return promptly.
+ *
+ * Only plain C types cross this boundary. Strings passed to emit() are
+ * copied by the host before it returns.
+ */
+#ifndef RADUX_PLUGIN_H
+#define RADUX_PLUGIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped on any incompatible change to the structures below */
+#define RADUX_PLUGIN_ABI_VERSION 1
+
+/* Name of the symbol every plugin exports */
+#define RADUX_PLUGIN_ENTRY "radux_plugin_entry"
+
+/* How long the host may reuse a provider's items */
+typedef enum radux_cache_mode {
+    RADUX_CACHE_NONE = 0,      /* Fetch every time the submenu opens */
+    RADUX_CACHE_SESSION = 1,   /* Fetch once per process */
+    RADUX_CACHE_TTL = 2        /* Reuse for cache_ttl_ms milliseconds */
+} radux_cache_mode;
+
+/* One menu item; NULL strings mean "unset" */
+typedef struct radux_item {
+    const char* label;         /* Required */
+    const char* command;       /* Leaf items: command to run */
+    const char* description;
+    const char* icon;          /* File path or icon theme name */
+    const char* hotkey;
+    const char* provider;      /* Nested dynamic submenu (another provider) */
+    const char* provider_arg;
+    int priority;              /* 0-10 */
+} radux_item;
+
+/* Opaque handle of one running fetch */
+typedef struct radux_request radux_request;
+
+/* Functions the host offers to plugins (safe to call from the fetch thread) */
+typedef struct radux_host_api {
+    uint32_t abi_version;
+
+    /* Deliver one item; returns 0 once the request has been cancelled */
+    int (*emit)(radux_request* request, const radux_item* item);
+
+    /* Returns 1 once the user has left the level */
+    int (*is_cancelled)(const radux_request* request);
+} radux_host_api;
+
+typedef struct radux_provider {
+    uint32_t abi_version;      /* Must be RADUX_PLUGIN_ABI_VERSION */
+    const char* name;          /* Referenced by "provider:" in the config */
+
+    radux_cache_mode cache_mode;
+    uint32_t cache_ttl_ms;     /* Used with RADUX_CACHE_TTL */
+
+    /* Optional: called once after loading; the result is passed to fetch() */
+    void* (*init)(const radux_host_api* host);
+
+    /* Optional: called once before unloading */
+    void (*shutdown)(void* state);
+
+    /* Required: produce the items for one submenu (worker thread) */
+    void (*fetch)(void* state, const radux_host_api* host,
+                  radux_request* request, const char* arg);
+} radux_provider;
+
+/* Exported by the plugin as RADUX_PLUGIN_ENTRY */
+typedef const radux_provider* (*radux_plugin_entry_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RADUX_PLUGIN_H */
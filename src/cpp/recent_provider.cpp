@@ -0,0 +1,298 @@
+#include "recent_provider.hpp"
+#include "shell_Utilities.hpp"
+#include "worker_pool.hpp"
+#include <glib.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Bytes handed to the markup parser at a time
+static const size_t READ_CHUNK_SIZE = 64 * 1024;
+
+// Parsed candidates kept per limit entry (room for files that were deleted since)
+static const size_t CANDIDATES_PER_ENTRY = 4;
+
+// The file changes whenever any application opens a document
+static const int RECENT_CACHE_TTL_MS = 2000;
+
+static int64_t parse_timestamp(const char* value) {
+    if (!value || value[0] == '\0') {
+        return 0;
+    }
+
+    GDateTime* date = g_date_time_new_from_iso8601(value, nullptr);
+    if (!date) {
+        return 0;
+    }
+    int64_t seconds = g_date_time_to_unix(date);
+    g_date_time_unref(date);
+    return seconds;
+}
+
+// Recent uses count fully, older ones fade (visit weights by age in days)
+static double frecency(int64_t time, int count, int64_t now) {
+    double age_days = static_cast<double>(now - time) / 86400.0;
+    double weight = age_days < 4 ? 100 : age_days < 14 ? 70 : age_days < 31 ? 50 : age_days < 90 ? 30 : 10;
+    return std::max(count, 1) * weight;
+}
+
+// Markup parser state: one bookmark is collected at a time
+struct XbelParser {
+    std::vector<RecentProvider::Entry>* entries;
+    RecentProvider::Entry current;
+    bool in_bookmark = false;
+};
+
+static void on_start_element(GMarkupParseContext*, const gchar* element,
+                             const gchar** names, const gchar** values,
+                             gpointer data, GError**) {
+    auto* parser = static_cast<XbelParser*>(data);
+
+    if (std::strcmp(element, "bookmark") == 0) {
+        parser->current = RecentProvider::Entry();
+        parser->in_bookmark = true;
+        for (int i = 0; names[i]; ++i) {
+            if (std::strcmp(names[i], "href") == 0) {
+                parser->current.uri = values[i];
+            } else if (std::strcmp(names[i], "modified") == 0 || std::strcmp(names[i], "visited") == 0 ||
+                       std::strcmp(names[i], "added") == 0) {
+                parser->current.time = std::max(parser->current.time, parse_timestamp(values[i]));
+            }
+        }
+        return;
+    }
+
+    if (!parser->in_bookmark) {
+        return;
+    }
+
+    if (std::strcmp(element, "mime:mime-type") == 0) {
+        for (int i = 0; names[i]; ++i) {
+            if (std::strcmp(names[i], "type") == 0) {
+                parser->current.mime_type = values[i];
+            }
+        }
+    } else if (std::strcmp(element, "bookmark:application") == 0) {
+        for (int i = 0; names[i]; ++i) {
+            if (std::strcmp(names[i], "count") == 0) {
+                parser->current.count += std::atoi(values[i]);
+            } else if (std::strcmp(names[i], "modified") == 0) {
+                parser->current.time = std::max(parser->current.time, parse_timestamp(values[i]));
+            } else if (std::strcmp(names[i], "timestamp") == 0) {
+                // Older writers store Unix seconds instead of ISO 8601
+                parser->current.time = std::max<int64_t>(parser->current.time, std::atoll(values[i]));
+            }
+        }
+    }
+}
+
+static void on_end_element(GMarkupParseContext*, const gchar* element, gpointer data, GError**) {
+    auto* parser = static_cast<XbelParser*>(data);
+
+    if (std::strcmp(element, "bookmark") == 0 && parser->in_bookmark) {
+        parser->in_bookmark = false;
+        if (parser->current.uri.compare(0, 7, "file://") == 0) {
+            parser->entries->push_back(std::move(parser->current));
+        }
+    }
+}
+
+RecentProvider::RecentProvider(const std::string& opener, int limit)
+    : opener_(opener.empty() ? "xdg-open" : opener)
+    , limit_(std::max(limit, 1))
+{
+    const char* data_home = std::getenv("XDG_DATA_HOME");
+    const char* home = std::getenv("HOME");
+    if (data_home && data_home[0] != '\0') {
+        path_ = std::string(data_home) + "/recently-used.xbel";
+    } else if (home) {
+        path_ = std::string(home) + "/.local/share/recently-used.xbel";
+    }
+}
+
+ProviderCachePolicy RecentProvider::cache_policy() const {
+    ProviderCachePolicy policy;
+    policy.mode = ProviderCacheMode::Ttl;
+    policy.ttl_ms = RECENT_CACHE_TTL_MS;
+    return policy;
+}
+
+void RecentProvider::fetch(const std::string& arg, ProviderRequest& request) {
+    int limit = limit_;
+    if (!arg.empty()) {
+        limit = std::max(std::atoi(arg.c_str()), 1);
+    }
+
+    struct stat st;
+    if (path_.empty() || stat(path_.c_str(), &st) != 0) {
+        return;  // No history yet
+    }
+
+    // Unchanged file: the previous ranking is reused as-is
+    // Changed file: the previous ranking still answers, and one re-rank runs behind it
+    size_t wanted = static_cast<size_t>(limit) * CANDIDATES_PER_ENTRY;
+    std::vector<Entry> ranked;
+    bool current = false;
+    bool stale = false;
+    bool start_revalidation = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current = st.st_size == parsed_size_ && st.st_mtim.tv_sec == parsed_mtime_.tv_sec &&
+                  st.st_mtim.tv_nsec == parsed_mtime_.tv_nsec && parsed_wanted_ >= wanted;
+        stale = !current && parsed_size_ >= 0;
+        if (current || stale) {
+            ranked = ranked_;
+        }
+        if (stale && !revalidating_) {
+            revalidating_ = true;
+            start_revalidation = true;
+            wanted = std::max(wanted, parsed_wanted_);
+        }
+    }
+
+    if (stale) {
+        // Not worth caching: the refresh replaces it shortly
+        request.set_cacheable(false);
+        if (start_revalidation) {
+            WorkerPool::instance().submit([self = shared_from_this(), wanted]() { self->revalidate(wanted); });
+        }
+    } else if (!current && !rank_file(st, wanted, &request, ranked)) {
+        return;
+    }
+
+    int emitted = 0;
+    for (const auto& entry : ranked) {
+        if (emitted >= limit) {
+            break;
+        }
+
+        gchar* path = g_filename_from_uri(entry.uri.c_str(), nullptr, nullptr);
+        if (!path) {
+            continue;
+        }
+        std::string file_path = path;
+        g_free(path);
+
+        // Deleted or unmounted files stay in the history
+        if (access(file_path.c_str(), F_OK) != 0) {
+            continue;
+        }
+
+        if (!request.emit(make_item(file_path, entry))) {
+            return;
+        }
+        ++emitted;
+    }
+}
+
+bool RecentProvider::rank_file(const struct stat& st, size_t wanted, const ProviderRequest* request,
+                               std::vector<Entry>& ranked) {
+    std::vector<Entry> entries;
+    if (!parse_file(request, entries)) {
+        return false;
+    }
+
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    for (auto& entry : entries) {
+        entry.score = frecency(entry.time, entry.count, now);
+    }
+
+    size_t kept = std::min(entries.size(), wanted);
+    std::partial_sort(entries.begin(), entries.begin() + kept, entries.end(),
+                      [](const Entry& a, const Entry& b) {
+                          return a.score != b.score ? a.score > b.score : a.time > b.time;
+                      });
+    entries.resize(kept);
+    ranked = entries;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ranked_ = std::move(entries);
+    parsed_mtime_ = st.st_mtim;
+    parsed_size_ = st.st_size;
+    parsed_wanted_ = wanted;
+    return true;
+}
+
+void RecentProvider::revalidate(size_t wanted) {
+    // The state is taken before parsing; a write during the parse shows as a new change
+    struct stat st;
+    std::vector<Entry> ranked;
+    bool ranked_again = stat(path_.c_str(), &st) == 0 && rank_file(st, wanted, nullptr, ranked);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        revalidating_ = false;
+    }
+
+    if (ranked_again) {
+        WorkerPool::run_on_main([]() { ProviderRegistry::instance().refresh("recent"); });
+    }
+}
+
+bool RecentProvider::parse_file(const ProviderRequest* request, std::vector<Entry>& entries) const {
+    int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    GMarkupParser callbacks = {on_start_element, on_end_element, nullptr, nullptr, nullptr};
+    XbelParser parser;
+    parser.entries = &entries;
+    GMarkupParseContext* context = g_markup_parse_context_new(&callbacks, static_cast<GMarkupParseFlags>(0),
+                                                              &parser, nullptr);
+
+    std::vector<char> buffer(READ_CHUNK_SIZE);
+    GError* error = nullptr;
+    bool ok = true;
+
+    while (ok) {
+        if (request && request->is_cancelled()) {
+            ok = false;
+            break;
+        }
+
+        ssize_t bytes = read(fd, buffer.data(), buffer.size());
+        if (bytes == 0) {
+            ok = g_markup_parse_context_end_parse(context, &error);
+            break;
+        }
+        if (bytes < 0) {
+            ok = false;
+            break;
+        }
+        ok = g_markup_parse_context_parse(context, buffer.data(), bytes, &error);
+    }
+
+    if (error) {
+        // A writer replacing the file mid-read leaves it truncated; keep what was read
+        std::cerr << "Recent: " << path_ << ": " << error->message << "\n";
+        g_error_free(error);
+        ok = !(request && request->is_cancelled());
+    }
+
+    g_markup_parse_context_free(context);
+    close(fd);
+    return ok;
+}
+
+MenuItem RecentProvider::make_item(const std::string& path, const Entry& entry) const {
+    size_t slash = path.find_last_of('/');
+
+    MenuItem item;
+    item.label = slash == std::string::npos ? path : path.substr(slash + 1);
+    item.description = path;
+    item.action = [opener = opener_, path]() { SafeExecutor::open_with(opener, path); };
+
+    // Themed icon named after the MIME type (e.g. text/plain -> text-plain)
+    if (!entry.mime_type.empty()) {
+        std::string icon = entry.mime_type;
+        std::replace(icon.begin(), icon.end(), '/', '-');
+        item.icon = icon;
+        item.label_with_icon = true;
+    }
+    return item;
+}
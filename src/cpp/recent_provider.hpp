@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "menu_provider.hpp"
+
+// Built-in "recent" provider: recently used documents from recently-used.xbel
+// The file is streamed through a markup parser on a worker thread and only
+// re-parsed when its mtime or size changed. A changed file does not hold up
+// the menu: the previous ranking answers at once, the file is ranked again
+// in the background, and open menus are refreshed when that is done
+class RecentProvider : public MenuProvider, public std::enable_shared_from_this<RecentProvider> {
+public:
+    // opener: command that receives the file path (e.g. "xdg-open")
+    // limit: entries shown unless the item's provider-arg gives a count
+    RecentProvider(const std::string& opener, int limit);
+
+    ProviderCachePolicy cache_policy() const override;
+    void fetch(const std::string& arg, ProviderRequest& request) override;
+
+    // One bookmark from the file
+    struct Entry {
+        std::string uri;
+        std::string mime_type;
+        int64_t time = 0;    // Most recent use (Unix seconds)
+        int count = 0;       // Uses summed over all applications
+        double score = 0.0;  // Frecency
+    };
+
+private:
+    std::string opener_;
+    int limit_;
+    std::string path_;
+
+    // Parsed ranking of the file as of (mtime, size)
+    std::mutex mutex_;
+    std::vector<Entry> ranked_;
+    struct timespec parsed_mtime_ = {0, 0};
+    off_t parsed_size_ = -1;
+    size_t parsed_wanted_ = 0;
+    bool revalidating_ = false;
+
+    // Parse and rank the file as of st, then keep the result (request: for cancellation, may be null)
+    bool rank_file(const struct stat& st, size_t wanted, const ProviderRequest* request,
+                   std::vector<Entry>& ranked);
+    void revalidate(size_t wanted);
+    bool parse_file(const ProviderRequest* request, std::vector<Entry>& entries) const;
+    MenuItem make_item(const std::string& path, const Entry& entry) const;
+};
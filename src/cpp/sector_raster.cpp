@@ -0,0 +1,280 @@
+#include "sector_raster.hpp"
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Below this many pixels a wedge is cheaper to rasterize on one thread
+static const int PARALLEL_MIN_PIXELS = 128 * 1024;
+
+// Rows per band handed to a worker
+static const int BAND_ROWS = 32;
+
+// Stands in for "no such edge" in the distance terms
+static const float FAR = 1e9f;
+
+// Half a turn (a wedge beyond it is not convex)
+static const double MAX_WEDGE_ANGLE = M_PI + 1e-9;
+
+namespace {
+
+// Premultiplied color in 0..1 floats
+struct Premultiplied {
+    float r, g, b, a;
+
+    explicit Premultiplied(const Color& color)
+        : r(static_cast<float>(color.r * color.a))
+        , g(static_cast<float>(color.g * color.a))
+        , b(static_cast<float>(color.b * color.a))
+        , a(static_cast<float>(color.a))
+    {
+    }
+};
+
+// Geometry shared by every row, in buffer pixel coordinates
+struct SectorSetup {
+    float cx, cy;
+    float inner, outer;        // inner: -FAR without a hole
+    float mid_cos, mid_sin;    // Rotates the wedge's bisector onto +x
+    float half_cos, half_sin;  // Half the wedge angle
+    bool wedge;                // false: full ring, no radial edges
+    float half_width;          // Half the border width
+    Premultiplied fill, border;
+};
+
+// Bands of rows run on the pool and on the calling thread; the caller also
+// claims bands, so a pool busy with slow jobs never holds up a frame
+struct RowBands {
+    std::function<void(int, int)> draw;
+    int height = 0;
+    int count = 0;
+    std::atomic<int> next{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+    int finished = 0;
+
+    void work() {
+        int finished_here = 0;
+        for (int band = next++; band < count; band = next++) {
+            int begin = band * BAND_ROWS;
+            draw(begin, std::min(begin + BAND_ROWS, height));
+            ++finished_here;
+        }
+        if (finished_here > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished += finished_here;
+            cv.notify_all();
+        }
+    }
+};
+
+}  // namespace
+
+// One row: coverage first (plain float math the compiler can vectorize), then packing
+static void rasterize_row(const SectorSetup& s, int y, uint32_t* row, int width,
+                          std::vector<float>& fill_cov, std::vector<float>& stroke_cov) {
+    float py = static_cast<float>(y) + 0.5f - s.cy;
+
+    for (int x = 0; x < width; ++x) {
+        float px = static_cast<float>(x) + 0.5f - s.cx;
+        float r = std::sqrt(px * px + py * py);
+
+        // Ring: outside either circle
+        float d = std::max(s.inner - r, r - s.outer);
+
+        // Wedge: distance to the nearer radial edge, folded onto one side of the bisector
+        if (s.wedge) {
+            float u = px * s.mid_cos + py * s.mid_sin;
+            float v = std::fabs(py * s.mid_cos - px * s.mid_sin);
+            d = std::max(d, v * s.half_cos - u * s.half_sin);
+        }
+
+        fill_cov[x] = std::clamp(0.5f - d, 0.0f, 1.0f);
+        stroke_cov[x] = std::clamp(0.5f + s.half_width - std::fabs(d), 0.0f, 1.0f);
+    }
+
+    for (int x = 0; x < width; ++x) {
+        float fc = fill_cov[x];
+        float sc = stroke_cov[x];
+
+        // Border over fill
+        float keep = fc * (1.0f - s.border.a * sc);
+        float a = s.border.a * sc + s.fill.a * keep;
+        float r = s.border.r * sc + s.fill.r * keep;
+        float g = s.border.g * sc + s.fill.g * keep;
+        float b = s.border.b * sc + s.fill.b * keep;
+
+        row[x] = (static_cast<uint32_t>(a * 255.0f + 0.5f) << 24) |
+                 (static_cast<uint32_t>(r * 255.0f + 0.5f) << 16) |
+                 (static_cast<uint32_t>(g * 255.0f + 0.5f) << 8) |
+                 static_cast<uint32_t>(b * 255.0f + 0.5f);
+    }
+}
+
+void rasterize_sector(const AnnularSector& sector, const Color& fill, const Color& border,
+                      double border_width, uint32_t* pixels, int stride_pixels,
+                      int width, int height) {
+    double span = sector.end_angle - sector.start_angle;
+    double mid = sector.start_angle + span / 2;
+
+    SectorSetup setup{
+        static_cast<float>(sector.cx), static_cast<float>(sector.cy),
+        sector.inner_radius > 0 ? static_cast<float>(sector.inner_radius) : -FAR,
+        static_cast<float>(sector.outer_radius),
+        static_cast<float>(std::cos(mid)), static_cast<float>(std::sin(mid)),
+        static_cast<float>(std::cos(span / 2)), static_cast<float>(std::sin(span / 2)),
+        span < 2 * M_PI,
+        static_cast<float>(border_width / 2),
+        Premultiplied(fill), Premultiplied(border)
+    };
+
+    auto draw_rows = [&setup, pixels, stride_pixels, width](int begin, int end) {
+        std::vector<float> fill_cov(width);
+        std::vector<float> stroke_cov(width);
+        for (int y = begin; y < end; ++y) {
+            rasterize_row(setup, y, pixels + static_cast<size_t>(y) * stride_pixels, width,
+                          fill_cov, stroke_cov);
+        }
+    };
+
+    auto& pool = WorkerPool::instance();
+    if (width * height < PARALLEL_MIN_PIXELS || pool.thread_count() == 0) {
+        draw_rows(0, height);
+        return;
+    }
+
+    auto bands = std::make_shared<RowBands>();
+    bands->draw = draw_rows;
+    bands->height = height;
+    bands->count = (height + BAND_ROWS - 1) / BAND_ROWS;
+
+    // Helpers that start after the last band is claimed return without touching the buffer
+    size_t helpers = std::min<size_t>(pool.thread_count(), static_cast<size_t>(bands->count - 1));
+    for (size_t i = 0; i < helpers; ++i) {
+        pool.submit([bands]() { bands->work(); });
+    }
+    bands->work();
+
+    std::unique_lock<std::mutex> lock(bands->mutex);
+    bands->cv.wait(lock, [&]() { return bands->finished == bands->count; });
+}
+
+// Pixel bounds of a sector: its corners plus every axis extreme inside its angle range
+static void sector_bounds(const AnnularSector& s, double pad,
+                          double& min_x, double& min_y, double& max_x, double& max_y) {
+    double span = s.end_angle - s.start_angle;
+    if (span >= 2 * M_PI || s.inner_radius <= 0) {
+        min_x = s.cx - s.outer_radius;
+        max_x = s.cx + s.outer_radius;
+        min_y = s.cy - s.outer_radius;
+        max_y = s.cy + s.outer_radius;
+    } else {
+        min_x = min_y = HUGE_VAL;
+        max_x = max_y = -HUGE_VAL;
+        auto include = [&](double radius, double angle) {
+            double x = s.cx + radius * std::cos(angle);
+            double y = s.cy + radius * std::sin(angle);
+            min_x = std::min(min_x, x);
+            max_x = std::max(max_x, x);
+            min_y = std::min(min_y, y);
+            max_y = std::max(max_y, y);
+        };
+
+        include(s.inner_radius, s.start_angle);
+        include(s.inner_radius, s.end_angle);
+        include(s.outer_radius, s.start_angle);
+        include(s.outer_radius, s.end_angle);
+
+        double first = std::ceil(s.start_angle / (M_PI / 2)) * (M_PI / 2);
+        for (double angle = first; angle <= s.end_angle; angle += M_PI / 2) {
+            include(s.outer_radius, angle);
+        }
+    }
+
+    min_x -= pad;
+    min_y -= pad;
+    max_x += pad;
+    max_y += pad;
+}
+
+bool paint_sector(const Cairo::RefPtr<Cairo::Context>& cr, const AnnularSector& sector,
+                  const Color& fill, const Color& border, double border_width) {
+    double span = sector.end_angle - sector.start_angle;
+    if (span <= 0) {
+        return true;
+    }
+    if (span < 2 * M_PI && span > MAX_WEDGE_ANGLE) {
+        return false;
+    }
+
+    // Translation plus uniform scale keeps a sector a sector
+    Cairo::Matrix matrix;
+    cr->get_matrix(matrix);
+    if (matrix.xy != 0 || matrix.yx != 0 || std::fabs(matrix.xx - matrix.yy) > 1e-9) {
+        return false;
+    }
+
+    double device_scale_x = 1;
+    double device_scale_y = 1;
+    cr->get_target()->get_device_scale(device_scale_x, device_scale_y);
+    if (device_scale_x != device_scale_y) {
+        return false;
+    }
+
+    // Scaled to nothing (first frame of the opening animation)
+    double scale = matrix.xx * device_scale_x;
+    if (scale <= 0) {
+        return matrix.xx == 0;
+    }
+
+    // Sector in target pixels
+    AnnularSector pixel = sector;
+    pixel.cx = (matrix.xx * sector.cx + matrix.x0) * device_scale_x;
+    pixel.cy = (matrix.yy * sector.cy + matrix.y0) * device_scale_x;
+    pixel.inner_radius = sector.inner_radius * scale;
+    pixel.outer_radius = sector.outer_radius * scale;
+    double width = border_width * scale;
+
+    double min_x, min_y, max_x, max_y;
+    sector_bounds(pixel, width / 2 + 1, min_x, min_y, max_x, max_y);
+    int x0 = static_cast<int>(std::floor(min_x));
+    int y0 = static_cast<int>(std::floor(min_y));
+    int w = static_cast<int>(std::ceil(max_x)) - x0;
+    int h = static_cast<int>(std::ceil(max_y)) - y0;
+    if (w <= 0 || h <= 0) {
+        return true;
+    }
+
+    // One scratch buffer for every wedge, grown to the largest seen; the top
+    // left w x h pixels are overwritten and only they are composited
+    // flush() first: a recording target (GTK's render nodes) that still
+    // refers to the last wedge's pixels gets its own copy before they change
+    static Cairo::RefPtr<Cairo::ImageSurface> scratch;
+    if (!scratch || scratch->get_width() < w || scratch->get_height() < h) {
+        int scratch_w = scratch ? std::max(scratch->get_width(), w) : w;
+        int scratch_h = scratch ? std::max(scratch->get_height(), h) : h;
+        scratch = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, scratch_w, scratch_h);
+    }
+    scratch->flush();
+    pixel.cx -= x0;
+    pixel.cy -= y0;
+    rasterize_sector(pixel, fill, border, width,
+                     reinterpret_cast<uint32_t*>(scratch->get_data()),
+                     scratch->get_stride() / 4, w, h);
+    scratch->mark_dirty(0, 0, w, h);
+    scratch->set_device_scale(device_scale_x, device_scale_y);
+
+    // Composite in device space, where the buffer was laid out
+    cr->save();
+    cr->set_identity_matrix();
+    cr->set_source(scratch, x0 / device_scale_x, y0 / device_scale_y);
+    cr->rectangle(x0 / device_scale_x, y0 / device_scale_y, w / device_scale_x, h / device_scale_y);
+    cr->fill();
+    cr->restore();
+    return true;
+}
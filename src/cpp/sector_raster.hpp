@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <cairomm/cairomm.h>
+#include "color_theme.hpp"
+
+// Analytic rasterizer for the menu's only shapes: annular sectors
+// Coverage comes from the shape's signed distance, so a wedge is filled and
+// stroked in one pass over its bounding box instead of flattening two arcs
+// into a polygon for Cairo's general rasterizer
+
+// Wedge of a ring (inner_radius 0: disc; full turn: no radial edges)
+struct AnnularSector {
+    double cx, cy;
+    double inner_radius, outer_radius;
+    double start_angle, end_angle;  // Radians, clockwise as in cairo_arc
+};
+
+// Fill, then stroke the outline centered on the edge (as fill_preserve + stroke)
+// Returns false when the current transform or shape is not supported
+// (rotation, shear, a wedge wider than half a turn); the caller draws with Cairo then
+// One thread only (the GTK thread): calls share a scratch buffer
+bool paint_sector(const Cairo::RefPtr<Cairo::Context>& cr, const AnnularSector& sector,
+                  const Color& fill, const Color& border, double border_width);
+
+// Rasterize into premultiplied ARGB32 pixels; sector in buffer pixel coordinates
+// Pixels are overwritten, not blended
+void rasterize_sector(const AnnularSector& sector, const Color& fill, const Color& border,
+                      double border_width, uint32_t* pixels, int stride_pixels,
+                      int width, int height);
@@ -0,0 +1,89 @@
+#include "segment_area.hpp"
+#include <gtk/gtk.h>
+
+SegmentArea::SegmentArea()
+    : Glib::ObjectBase("SegmentArea")
+    , Gtk::DrawingArea()
+{
+    // Cached nodes are laid out for the old size
+    signal_resize().connect([this](int, int) { clear_nodes(); });
+}
+
+SegmentArea::~SegmentArea() {
+    clear_nodes();
+}
+
+void SegmentArea::set_segmented(bool segmented) {
+    segmented_ = segmented;
+    clear_nodes();
+    queue_draw();
+}
+
+void SegmentArea::set_parts(int count, const PartBoundsFunc& bounds, const PartDrawFunc& draw) {
+    clear_nodes();
+    part_count_ = count;
+    bounds_func_ = bounds;
+    draw_func_ = draw;
+    nodes_.assign(count, nullptr);
+}
+
+void SegmentArea::invalidate_part(int part) {
+    if (part < 0 || part >= static_cast<int>(nodes_.size())) {
+        return;
+    }
+
+    if (nodes_[part]) {
+        gsk_render_node_unref(nodes_[part]);
+        nodes_[part] = nullptr;
+    }
+    queue_draw();
+}
+
+void SegmentArea::invalidate_parts() {
+    for (auto& node : nodes_) {
+        if (node) {
+            gsk_render_node_unref(node);
+            node = nullptr;
+        }
+    }
+    queue_draw();
+}
+
+void SegmentArea::clear_nodes() {
+    for (auto& node : nodes_) {
+        if (node) {
+            gsk_render_node_unref(node);
+            node = nullptr;
+        }
+    }
+}
+
+void SegmentArea::snapshot_vfunc(const Glib::RefPtr<Gtk::Snapshot>& snapshot) {
+    if (!segmented_ || !draw_func_ || !bounds_func_) {
+        Gtk::DrawingArea::snapshot_vfunc(snapshot);
+        return;
+    }
+
+    for (int i = 0; i < part_count_; ++i) {
+        if (!nodes_[i]) {
+            Gdk::Rectangle bounds = bounds_func_(i);
+            graphene_rect_t rect = GRAPHENE_RECT_INIT(
+                static_cast<float>(bounds.get_x()), static_cast<float>(bounds.get_y()),
+                static_cast<float>(bounds.get_width()), static_cast<float>(bounds.get_height()));
+
+            GskRenderNode* node = gsk_cairo_node_new(&rect);
+
+            // The context owns its reference; drawing is flushed when it goes away
+            {
+                auto cr = Cairo::make_refptr_for_instance<Cairo::Context>(
+                    new Cairo::Context(gsk_cairo_node_get_draw_context(node), true));
+                draw_func_(cr, i);
+            }
+
+            nodes_[i] = node;
+        }
+
+        // Reusing the same node pointer tells GSK this part has no damage
+        gtk_snapshot_append_node(snapshot->gobj(), nodes_[i]);
+    }
+}
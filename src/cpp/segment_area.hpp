@@ -0,0 +1,41 @@
+#pragma once
+
+#include <gtkmm.h>
+#include <functional>
+#include <vector>
+
+// Drawing area that can render as independent, cached parts
+// In segmented mode every part (menu segment, center disc) is its own render
+// node; unchanged parts reuse last frame's node, so GSK only repaints (and
+// sends to the X server) the bounds of the parts that were invalidated.
+class SegmentArea : public Gtk::DrawingArea {
+public:
+    using PartBoundsFunc = std::function<Gdk::Rectangle(int part)>;
+    using PartDrawFunc = std::function<void(const Cairo::RefPtr<Cairo::Context>& cr, int part)>;
+
+    SegmentArea();
+    ~SegmentArea() override;
+
+    // Enable or disable per-part rendering (disabled: plain draw func)
+    void set_segmented(bool segmented);
+    bool is_segmented() const { return segmented_; }
+
+    // Describe the parts to render; drops every cached node
+    void set_parts(int count, const PartBoundsFunc& bounds, const PartDrawFunc& draw);
+
+    // Drop the cached node of one part (or all parts) and schedule a redraw
+    void invalidate_part(int part);
+    void invalidate_parts();
+
+protected:
+    void snapshot_vfunc(const Glib::RefPtr<Gtk::Snapshot>& snapshot) override;
+
+private:
+    bool segmented_ = false;
+    int part_count_ = 0;
+    PartBoundsFunc bounds_func_;
+    PartDrawFunc draw_func_;
+    std::vector<GskRenderNode*> nodes_;
+
+    void clear_nodes();
+};
@@ -4,6 +4,9 @@
 #include <sstream>
 #include <vector>
 #include <algorithm>
+#include <iostream>
+#include <glibmm/shell.h>
+#include <glibmm/spawn.h>
 
 // Shell escape utilities for safe command execution
 class ShellEscaper {
@@ -215,6 +218,21 @@ public:
         return result;
     }
 
+    // Start opener (a command line, possibly with options) with one more
+    // argument, without a shell: the argument arrives verbatim, whatever
+    // characters it holds (file names with ';' or '$(' included)
+    static bool open_with(const std::string& opener, const std::string& argument) {
+        try {
+            std::vector<std::string> argv = Glib::shell_parse_argv(opener);
+            argv.push_back(argument);
+            Glib::spawn_async("", argv, Glib::SpawnFlags::SEARCH_PATH);
+            return true;
+        } catch (const Glib::Error& e) {
+            std::cerr << "Failed to run " << opener << ": " << e.what() << "\n";
+            return false;
+        }
+    }
+
     // Execute command asynchronously (fire and forget)
     static bool execute_async(const std::string& command, const std::vector<std::string>& args = {}) {
         std::string full_cmd = command;
@@ -0,0 +1,243 @@
+// App launching against a private session bus (run under dbus-run-session)
+// This process stands in for a D-Bus activatable application: it owns the
+// app's bus name and answers org.freedesktop.Application.Activate. Apps the
+// bus cannot reach, or that answer with an error, must be spawned instead
+
+#include "check.hpp"
+#include "app_launcher.hpp"
+#include <giomm/init.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* SERVICE_XML =
+    "<node>"
+    "  <interface name='org.freedesktop.Application'>"
+    "    <method name='Activate'>"
+    "      <arg type='a{sv}' name='platform_data' direction='in'/>"
+    "    </method>"
+    "  </interface>"
+    "</node>";
+
+// One fake application on the bus
+struct FakeApp {
+    std::string name;
+    bool fail = false;   // Answer Activate with an error
+    int delay_ms = 0;    // Answer this late
+    int activations = 0;
+    bool answered = false;
+
+    void on_method_call(const Glib::RefPtr<Gio::DBus::Connection>&, const Glib::ustring&,
+                        const Glib::ustring&, const Glib::ustring&, const Glib::ustring& method_name,
+                        const Glib::VariantContainerBase&,
+                        const Glib::RefPtr<Gio::DBus::MethodInvocation>& invocation) {
+        if (method_name != "Activate") {
+            invocation->return_error(Gio::DBus::Error(Gio::DBus::Error::UNKNOWN_METHOD, method_name));
+            return;
+        }
+        ++activations;
+        auto answer = [this, invocation]() {
+            answered = true;
+            if (fail) {
+                invocation->return_error(Gio::DBus::Error(Gio::DBus::Error::FAILED, "refusing to activate"));
+                return;
+            }
+            invocation->return_value(Glib::VariantContainerBase());
+        };
+        if (delay_ms > 0) {
+            Glib::signal_timeout().connect_once(answer, delay_ms);
+        } else {
+            answer();
+        }
+    }
+};
+
+// Own app.name on the bus and serve its object (false if the name is taken)
+static bool serve(const Glib::RefPtr<Gio::DBus::Connection>& bus, FakeApp& app,
+                  const Glib::RefPtr<Gio::DBus::InterfaceInfo>& interface,
+                  Gio::DBus::InterfaceVTable& vtable) {
+    bus->register_object(AppLauncher::object_path_for(app.name), interface, vtable);
+
+    const guint32 DO_NOT_QUEUE = 4;
+    const guint32 PRIMARY_OWNER = 1;
+    auto reply = bus->call_sync("/org/freedesktop/DBus", "org.freedesktop.DBus", "RequestName",
+                                Glib::VariantContainerBase::create_tuple(
+                                    {Glib::Variant<Glib::ustring>::create(app.name),
+                                     Glib::Variant<guint32>::create(DO_NOT_QUEUE)}),
+                                "org.freedesktop.DBus");
+    Glib::Variant<guint32> result;
+    reply.get_child(result, 0);
+    return result.get() == PRIMARY_OWNER;
+}
+
+static void write_desktop_file(const std::string& dir, const std::string& id,
+                               bool activatable, const std::string& exec) {
+    std::ofstream file(dir + "/applications/" + id + ".desktop");
+    file << "[Desktop Entry]\n"
+         << "Type=Application\n"
+         << "Name=" << id << "\n"
+         << "Exec=" << exec << "\n"
+         << (activatable ? "DBusActivatable=true\n" : "");
+}
+
+static bool exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Run the main loop a little longer (for things that must not happen)
+static void settle() {
+    pump_until([start = std::chrono::steady_clock::now()]() {
+        return std::chrono::steady_clock::now() - start > std::chrono::milliseconds(300);
+    });
+}
+
+int main() {
+    if (!std::getenv("DBUS_SESSION_BUS_ADDRESS")) {
+        std::cerr << "No session bus, skipping\n";
+        return SKIPPED;
+    }
+
+    // Desktop files come from a scratch data dir, read before GIO starts
+    char dir_template[] = "/tmp/radux-launcher-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        return SKIPPED;
+    }
+    std::string dir = dir_template;
+    std::string apps = dir + "/applications";
+    if (mkdir(apps.c_str(), 0700) != 0) {
+        return SKIPPED;
+    }
+    setenv("XDG_DATA_HOME", dir.c_str(), 1);
+    setenv("XDG_DATA_DIRS", dir.c_str(), 1);
+
+    // Activatable and served, activatable but refusing, activatable but
+    // absent from the bus, and a plain app
+    write_desktop_file(dir, "org.radux.Served", true, "touch " + dir + "/served");
+    write_desktop_file(dir, "org.radux.Refusing", true, "touch " + dir + "/refusing");
+    write_desktop_file(dir, "org.radux.Missing", true, "touch " + dir + "/missing");
+    write_desktop_file(dir, "org.radux.Plain", false, "touch " + dir + "/plain");
+    write_desktop_file(dir, "org.radux.Slow", true, "touch " + dir + "/slow");
+
+    // Exec lines the command blacklist refuses
+    write_desktop_file(dir, "org.radux.Blocked", false, "rm " + dir + "/keep");
+    write_desktop_file(dir, "org.radux.BlockedActivatable", true, "rm " + dir + "/keep");
+
+    Gio::init();
+    Glib::RefPtr<Gio::DBus::Connection> bus;
+    try {
+        bus = Gio::DBus::Connection::get_sync(Gio::DBus::BusType::SESSION);
+    } catch (const Glib::Error& e) {
+        std::cerr << "No session bus (" << e.what() << "), skipping\n";
+        return SKIPPED;
+    }
+
+    // Names and paths per the Desktop Entry spec
+    CHECK(AppLauncher::bus_name_for("org.radux.Served.desktop") == "org.radux.Served");
+    CHECK(AppLauncher::bus_name_for("org.radux.Served") == "org.radux.Served");
+    CHECK(AppLauncher::object_path_for("org.radux.Served.desktop") == "/org/radux/Served");
+    CHECK(AppLauncher::object_path_for("org.radux.my-app") == "/org/radux/my_app");
+
+    auto node = Gio::DBus::NodeInfo::create_for_xml(SERVICE_XML);
+    auto interface = node->lookup_interface("org.freedesktop.Application");
+
+    FakeApp served;
+    served.name = "org.radux.Served";
+    FakeApp refusing;
+    refusing.name = "org.radux.Refusing";
+    refusing.fail = true;
+    FakeApp slow;
+    slow.name = "org.radux.Slow";
+    slow.fail = true;
+    slow.delay_ms = 300;
+    FakeApp blocked;
+    blocked.name = "org.radux.BlockedActivatable";
+    Gio::DBus::InterfaceVTable served_vtable(sigc::mem_fun(served, &FakeApp::on_method_call));
+    Gio::DBus::InterfaceVTable refusing_vtable(sigc::mem_fun(refusing, &FakeApp::on_method_call));
+    Gio::DBus::InterfaceVTable slow_vtable(sigc::mem_fun(slow, &FakeApp::on_method_call));
+    Gio::DBus::InterfaceVTable blocked_vtable(sigc::mem_fun(blocked, &FakeApp::on_method_call));
+    CHECK(serve(bus, served, interface, served_vtable));
+    CHECK(serve(bus, refusing, interface, refusing_vtable));
+    CHECK(serve(bus, slow, interface, slow_vtable));
+    CHECK(serve(bus, blocked, interface, blocked_vtable));
+
+    auto& launcher = AppLauncher::instance();
+
+    // A served app is activated, not spawned
+    CHECK(launcher.launch("org.radux.Served", ""));
+    CHECK(pump_until([&]() { return served.activations == 1; }));
+    settle();
+    CHECK(served.activations == 1);
+    CHECK(!exists(dir + "/served"));
+
+    // A refused activation spawns the Exec line (not a second activation)
+    CHECK(launcher.launch("org.radux.Refusing.desktop", ""));
+    CHECK(pump_until([&]() { return exists(dir + "/refusing"); }));
+    CHECK(refusing.activations == 1);
+
+    // Nothing owns the name: spawned as well
+    CHECK(launcher.launch("org.radux.Missing", ""));
+    CHECK(pump_until([&]() { return exists(dir + "/missing"); }));
+
+    // A fallback command replaces the Exec line
+    unlink((dir + "/missing").c_str());
+    CHECK(launcher.launch("org.radux.Missing", "touch " + dir + "/fallback"));
+    CHECK(pump_until([&]() { return exists(dir + "/fallback"); }));
+    settle();
+    CHECK(!exists(dir + "/missing"));
+
+    // Apps without DBusActivatable never touch the bus
+    CHECK(launcher.launch("org.radux.Plain", ""));
+    CHECK(pump_until([&]() { return exists(dir + "/plain"); }));
+
+    // Unknown IDs start nothing unless there is a fallback
+    CHECK(!launcher.launch("org.radux.Unknown", ""));
+    CHECK(launcher.launch("org.radux.Unknown", "touch " + dir + "/unknown"));
+    CHECK(pump_until([&]() { return exists(dir + "/unknown"); }));
+
+    // A blacklisted Exec line starts nothing, over the bus or not, unless the
+    // item brings its own command
+    CHECK(!launcher.launch("org.radux.Blocked", ""));
+    CHECK(!launcher.launch("org.radux.BlockedActivatable", ""));
+    settle();
+    CHECK(blocked.activations == 0);
+    CHECK(launcher.launch("org.radux.Blocked", "touch " + dir + "/allowed"));
+    CHECK(pump_until([&]() { return exists(dir + "/allowed"); }));
+
+    // A one-shot application stays up until a late refusal has been handled
+    auto application = Gio::Application::create("org.radux.LauncherTest", Gio::Application::Flags::NON_UNIQUE);
+    application->signal_activate().connect([&]() { launcher.launch("org.radux.Slow", ""); });
+    char arg0[] = "app_launcher_test";
+    char* argv[] = {arg0, nullptr};
+    application->run(1, argv);
+    CHECK(slow.activations == 1);
+    CHECK(slow.answered);
+    CHECK(pump_until([&]() { return exists(dir + "/slow"); }));
+
+    for (const char* name : {"refusing", "missing", "fallback", "plain", "unknown", "allowed", "slow"}) {
+        unlink((dir + "/" + name).c_str());
+    }
+    for (const char* id : {"Served", "Refusing", "Missing", "Plain", "Slow", "Blocked", "BlockedActivatable"}) {
+        unlink((apps + "/org.radux." + id + ".desktop").c_str());
+    }
+    rmdir(apps.c_str());
+    rmdir(dir.c_str());
+    return check_result();
+}
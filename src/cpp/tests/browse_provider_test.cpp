@@ -0,0 +1,170 @@
+// Directory browsing: the getdents64 listing and its order, the limit,
+// refresh on change, and opening names that look like shell syntax
+// Runs in a scratch directory; the opener is a script that records its
+// arguments
+
+#include "check.hpp"
+#include "browse_provider.hpp"
+#include <glibmm/init.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::string dir;
+
+static void write_file(const std::string& path, const std::string& contents = "") {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+static bool exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Items of one complete fetch (from the registry's cache if it has them)
+static std::vector<MenuItem> fetch(const std::string& provider, const std::string& path) {
+    auto request = ProviderRegistry::instance().request(provider, path);
+    if (!pump_until([&]() { return request->is_done(); })) {
+        return {};
+    }
+    return request->items();
+}
+
+static std::vector<std::string> labels(const std::vector<MenuItem>& items) {
+    std::vector<std::string> result;
+    for (const auto& item : items) {
+        result.push_back(item.label);
+    }
+    return result;
+}
+
+static const MenuItem* find(const std::vector<MenuItem>& items, const std::string& label) {
+    for (const auto& item : items) {
+        if (item.label == label) {
+            return &item;
+        }
+    }
+    return nullptr;
+}
+
+// Run an item's action and wait for the opener to record one more line
+static std::string open(const MenuItem* item) {
+    if (!item || !item->action) {
+        return "(no action)";
+    }
+    std::string log = dir + "/opened";
+    size_t before = read_file(log).size();
+    item->action();
+    if (!pump_until([&]() { return read_file(log).size() > before; })) {
+        return "(not opened)";
+    }
+    std::string line = read_file(log).substr(before);
+    return line.substr(0, line.find('\n'));
+}
+
+int main() {
+    char dir_template[] = "/tmp/radux-browse-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        return SKIPPED;
+    }
+    dir = dir_template;
+    Glib::init();
+
+    std::string opener = dir + "/opener";
+    write_file(opener, "#!/bin/sh\nprintf '%s\\n' \"$1\" >> " + dir + "/opened\n");
+    chmod(opener.c_str(), 0700);
+
+    // A small tree: directories (one through a symlink), mixed-case names,
+    // names a shell would run, and a dotfile
+    std::string tree = dir + "/tree";
+    mkdir(tree.c_str(), 0700);
+    mkdir((tree + "/Zdir").c_str(), 0700);
+    mkdir((tree + "/adir").c_str(), 0700);
+    CHECK(symlink((tree + "/adir").c_str(), (tree + "/link").c_str()) == 0);
+    for (const char* name : {"b.txt", "a.txt", "A.txt", "semi;colon", "$(touch pwned)", ".hidden"}) {
+        write_file(tree + "/" + name);
+    }
+
+    auto& registry = ProviderRegistry::instance();
+    registry.add("browse", std::make_shared<BrowseProvider>(opener, 64, false));
+    registry.add("browse-hidden", std::make_shared<BrowseProvider>(opener, 64, true));
+    registry.add("browse-few", std::make_shared<BrowseProvider>(opener, 3, false));
+
+    // "Open" first, then directories, then files, case-insensitively by name
+    auto items = fetch("browse", tree);
+    CHECK((labels(items) == std::vector<std::string>{"Open", "adir", "link", "Zdir", "$(touch pwned)",
+                                                      "A.txt", "a.txt", "b.txt", "semi;colon"}));
+    if (items.size() == 9) {
+        CHECK(items[0].description == tree);
+        CHECK(items[2].provider == "browse" && items[2].provider_arg == tree + "/link");
+        CHECK(items[4].provider.empty() && items[4].description == tree + "/$(touch pwned)");
+    }
+
+    // Dotfiles only when asked for
+    CHECK(find(fetch("browse-hidden", tree), ".hidden") != nullptr);
+
+    // Past the limit: the shown entries are the first ones in order
+    auto few = fetch("browse-few", tree);
+    CHECK((labels(few) == std::vector<std::string>{"Open", "adir", "link", "Zdir"}));
+    CHECK(!few.empty() && few[0].description == tree + "\n(5 more not shown)");
+
+    // Names are passed to the opener as they are, never through a shell
+    CHECK(open(find(items, "semi;colon")) == tree + "/semi;colon");
+    CHECK(open(find(items, "$(touch pwned)")) == tree + "/$(touch pwned)");
+    CHECK(open(find(items, "Open")) == tree);
+    CHECK(!exists("pwned") && !exists(tree + "/pwned"));
+    CHECK(find(items, "semi;colon")->command.empty());
+
+    // A change in the directory drops the cached listing
+    write_file(tree + "/c.txt");
+    CHECK(pump_until([&]() { return find(fetch("browse", tree), "c.txt") != nullptr; }));
+
+    // A directory too large for one getdents64 buffer is read completely
+    std::string big = dir + "/big";
+    mkdir(big.c_str(), 0700);
+    const int BIG_COUNT = 3000;
+    for (int i = BIG_COUNT - 1; i >= 0; --i) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "entry-%05d-with-a-name-long-enough-to-fill-buffers", i);
+        write_file(big + "/" + name);
+    }
+    registry.add("browse-all", std::make_shared<BrowseProvider>(opener, BIG_COUNT, false));
+    auto all = fetch("browse-all", big);
+    CHECK(all.size() == BIG_COUNT + 1);
+    bool sorted = true;
+    for (size_t i = 2; i < all.size(); ++i) {
+        sorted = sorted && all[i - 1].label < all[i].label;
+    }
+    CHECK(sorted);
+
+    CHECK(std::system(("rm -rf " + dir).c_str()) == 0);
+    return check_result();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <iostream>
+
+// Minimal checks for the test programs
+// A failed CHECK is reported and counted; main() returns check_result()
+// Programs whose environment is missing (no X server, no bus) return SKIPPED
+
+static const int SKIPPED = 77;  // SKIP_RETURN_CODE in tests/CMakeLists.txt
+
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition "\n"; \
+            ++check_failures();                                                       \
+        }                                                                             \
+    } while (0)
+
+inline int check_result() {
+    if (check_failures() > 0) {
+        std::cerr << check_failures() << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Clipboard history against a real X server (run under xvfb-run)
+// A second X client owns CLIPBOARD the way an application would; the history
+// must record its text, keep duplicates once, honour both caps, and serve an
+// entry back when one is chosen
+
+#include "check.hpp"
+#include "clipboard_history.hpp"
+#include <glibmm/init.h>
+#include <gtk/gtk.h>
+#include <gdk/x11/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Another application on its own connection
+struct OtherClient {
+    Display* display = nullptr;
+    Window window = None;
+    Atom clipboard = None;
+    Atom utf8_string = None;
+    Atom targets = None;
+    Atom property = None;
+    Atom timestamp = None;
+
+    std::string text;                   // Served while owning CLIPBOARD
+    std::optional<std::string> received;  // Result of the last request()
+
+    bool open() {
+        display = XOpenDisplay(nullptr);
+        if (!display) {
+            return false;
+        }
+        window = XCreateSimpleWindow(display, DefaultRootWindow(display), -10, -10, 1, 1, 0, 0, 0);
+        XSelectInput(display, window, PropertyChangeMask);
+        clipboard = XInternAtom(display, "CLIPBOARD", False);
+        utf8_string = XInternAtom(display, "UTF8_STRING", False);
+        targets = XInternAtom(display, "TARGETS", False);
+        property = XInternAtom(display, "OTHER_CLIPBOARD", False);
+        timestamp = XInternAtom(display, "OTHER_TIMESTAMP", False);
+        return true;
+    }
+
+    ~OtherClient() {
+        if (display) {
+            XCloseDisplay(display);
+        }
+    }
+
+    Time server_time() {
+        XChangeProperty(display, window, timestamp, XA_STRING, 8, PropModeAppend, nullptr, 0);
+        XEvent event;
+        XWindowEvent(display, window, PropertyChangeMask, &event);
+        return event.xproperty.time;
+    }
+
+    void own(const std::string& value) {
+        text = value;
+        XSetSelectionOwner(display, clipboard, window, server_time());
+        XFlush(display);
+    }
+
+    void request() {
+        received.reset();
+        XConvertSelection(display, clipboard, utf8_string, property, window, server_time());
+        XFlush(display);
+    }
+
+    // Answer selection requests and collect converted text
+    void serve() {
+        while (XPending(display)) {
+            XEvent event;
+            XNextEvent(display, &event);
+            if (event.type == SelectionRequest) {
+                answer(event.xselectionrequest);
+            } else if (event.type == SelectionNotify && event.xselection.property != None) {
+                Atom type = None;
+                int format = 0;
+                unsigned long count = 0;
+                unsigned long remaining = 0;
+                unsigned char* value = nullptr;
+                if (XGetWindowProperty(display, window, property, 0, 1 << 16, True, AnyPropertyType,
+                                       &type, &format, &count, &remaining, &value) == Success && value) {
+                    received = std::string(reinterpret_cast<char*>(value), count);
+                    XFree(value);
+                }
+            }
+        }
+    }
+
+    void answer(const XSelectionRequestEvent& request) {
+        XSelectionEvent reply = {};
+        reply.type = SelectionNotify;
+        reply.requestor = request.requestor;
+        reply.selection = request.selection;
+        reply.target = request.target;
+        reply.time = request.time;
+        reply.property = request.property;
+
+        if (request.target == utf8_string || request.target == XA_STRING) {
+            XChangeProperty(display, request.requestor, request.property, request.target, 8,
+                            PropModeReplace, reinterpret_cast<const unsigned char*>(text.data()),
+                            static_cast<int>(text.size()));
+        } else if (request.target == targets) {
+            Atom supported[] = {targets, utf8_string, XA_STRING};
+            XChangeProperty(display, request.requestor, request.property, XA_ATOM, 32,
+                            PropModeReplace, reinterpret_cast<unsigned char*>(supported), 3);
+        } else {
+            reply.property = None;
+        }
+        XSendEvent(display, request.requestor, False, NoEventMask, reinterpret_cast<XEvent*>(&reply));
+        XFlush(display);
+    }
+};
+
+// Items the provider would show, newest first
+static std::vector<MenuItem> snapshot(ClipboardHistory& history) {
+    auto request = std::make_shared<ProviderRequest>();
+    history.fetch("", *request);
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    return request->items();
+}
+
+static std::vector<std::string> descriptions(ClipboardHistory& history) {
+    std::vector<std::string> result;
+    for (const auto& item : snapshot(history)) {
+        result.push_back(item.description);
+    }
+    return result;
+}
+
+// Run both clients until done() holds (false after a few seconds)
+static bool pump_until(OtherClient& other, const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        other.serve();
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+static bool copy(OtherClient& other, ClipboardHistory& history, const std::string& text) {
+    other.own(text);
+    return pump_until(other, [&]() {
+        auto items = snapshot(history);
+        return !items.empty() && items.front().description == text;
+    });
+}
+
+int main() {
+    Glib::init();
+    gtk_init();
+    GdkDisplay* gdk_display = gdk_display_get_default();
+    if (!gdk_display || !GDK_IS_X11_DISPLAY(gdk_display)) {
+        std::cerr << "No X11 display, skipping\n";
+        return SKIPPED;
+    }
+
+    OtherClient other;
+    if (!other.open()) {
+        return SKIPPED;
+    }
+
+    // Four entries, and the smallest byte cap the history accepts
+    auto history = std::make_shared<ClipboardHistory>(4, 1024);
+    CHECK(history->start());
+
+    // Recorded newest first
+    CHECK(copy(other, *history, "alpha"));
+    CHECK(copy(other, *history, "beta"));
+    CHECK((descriptions(*history) == std::vector<std::string>{"beta", "alpha"}));
+
+    // Copying a known text again only moves it to the front
+    CHECK(copy(other, *history, "alpha"));
+    CHECK((descriptions(*history) == std::vector<std::string>{"alpha", "beta"}));
+
+    // Entry cap: the oldest goes first
+    CHECK(copy(other, *history, "one"));
+    CHECK(copy(other, *history, "two"));
+    CHECK(copy(other, *history, "three"));
+    CHECK((descriptions(*history) == std::vector<std::string>{"three", "two", "one", "alpha"}));
+
+    // Byte cap: two 600-byte texts do not fit in 1024 bytes together
+    std::string first = "first " + std::string(594, 'x');
+    std::string second = "second " + std::string(593, 'y');
+    CHECK(copy(other, *history, first));
+    CHECK((descriptions(*history).size() == 4));  // 611 bytes still fit
+    other.own(second);
+    CHECK(pump_until(other, [&]() {
+        auto items = snapshot(*history);
+        return !items.empty() && items.front().label.rfind("second", 0) == 0;
+    }));
+    auto items = snapshot(*history);
+    CHECK(items.size() == 1);
+
+    // Choosing an entry makes us the owner; the other client pastes it
+    CHECK(copy(other, *history, "gamma"));
+    items = snapshot(*history);
+    CHECK(!items.empty() && items.front().action);
+    if (!items.empty() && items.front().action) {
+        items.front().action();
+        other.request();
+        CHECK(pump_until(other, [&]() { return other.received.has_value(); }));
+        CHECK(other.received && *other.received == "gamma");
+    }
+
+    return check_result();
+}
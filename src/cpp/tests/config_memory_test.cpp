@@ -0,0 +1,120 @@
+// Heap budgets of config loading (built with the allocator hooks)
+// Generated configs of growing size and nesting go through from_yaml(); the
+// model must stay within BYTES_PER_ITEM per MenuItem plus vector slack, the
+// YAML DOM and the model may each peak at a fixed allowance plus a per-item
+// budget, and the DOM must be gone once loading returns
+// Budgets are the largest values measured over these shapes (x86-64,
+// libstdc++, yaml-cpp 0.7) plus 10%, so a real regression fails the test
+
+#include "check.hpp"
+#include "config_loader.hpp"
+#include "memory_stats.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Live model bytes per item, MenuItem itself and its strings (measured 655-662)
+// Unused vector capacity is checked on its own: growth at most doubles it
+static const int64_t BYTES_PER_ITEM = 728;
+
+// Peaks while loading: independent of size (lookups, theme, blacklist) plus
+// per item (measured with a 16 KiB fixed part: YAML 4802, config 1499, the
+// latter mostly old and new item vectors both held while one grows)
+static const int64_t FIXED_PEAK = 18 * 1024;
+static const int64_t YAML_PEAK_PER_ITEM = 5300;
+static const int64_t CONFIG_PEAK_PER_ITEM = 1650;
+
+struct Shape {
+    int width;  // Items per level
+    int depth;  // Levels (the first item of each level opens the next)
+};
+
+// Items like a hand-written config's: label, command, description, icon, hotkey
+static void write_level(std::ofstream& out, const Shape& shape, int level, const std::string& indent, int& count) {
+    for (int i = 0; i < shape.width; ++i) {
+        std::string name = "Item " + std::to_string(level) + "." + std::to_string(i);
+        out << indent << "- label: \"" << name << "\"\n"
+            << indent << "  description: \"Runs the command for " << name << "\"\n"
+            << indent << "  icon: \"utilities-terminal\"\n"
+            << indent << "  hotkey: \"" << (i % 9 + 1) << "\"\n";
+        ++count;
+        if (i == 0 && level + 1 < shape.depth) {
+            out << indent << "  submenu:\n";
+            write_level(out, shape, level + 1, indent + "    ", count);
+        } else {
+            out << indent << "  command: \"notify-send '" << name << "'\"\n";
+        }
+    }
+}
+
+static int count_items(const std::vector<MenuItem>& items) {
+    int count = 0;
+    for (const auto& item : items) {
+        count += 1 + count_items(item.submenu);
+    }
+    return count;
+}
+
+// Bytes allocated for items that are not there (capacity beyond size)
+static int64_t vector_slack(const std::vector<MenuItem>& items) {
+    int64_t slack = static_cast<int64_t>((items.capacity() - items.size()) * sizeof(MenuItem));
+    for (const auto& item : items) {
+        slack += vector_slack(item.submenu);
+    }
+    return slack;
+}
+
+int main() {
+    if (!MemoryStats::enabled()) {
+        std::cerr << "Built without RADUX_MEMORY_STATS, skipping\n";
+        return SKIPPED;
+    }
+
+    char path[] = "/tmp/radux-memory-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return SKIPPED;
+    }
+    close(fd);
+
+    // yaml-cpp keeps some tables for good after its first parse
+    {
+        std::ofstream out(path);
+        out << "items:\n  - label: \"Warm up\"\n    command: \"true\"\n";
+    }
+    RadialConfig::from_yaml(path);
+    int64_t yaml_resident = MemoryStats::current(MemoryTag::Yaml);
+
+    // Peaks only grow, so shapes go from small to large
+    const Shape shapes[] = {{8, 1}, {12, 4}, {100, 1}, {40, 8}, {1000, 1}, {200, 16}, {5000, 1}};
+    for (const auto& shape : shapes) {
+        int written = 0;
+        {
+            std::ofstream out(path);
+            out << "radius: 120\nitems:\n";
+            write_level(out, shape, 0, "  ", written);
+        }
+
+        int64_t config_before = MemoryStats::current(MemoryTag::Config);
+        RadialConfig config = RadialConfig::from_yaml(path);
+        int loaded = count_items(config.items);
+        int64_t slack = vector_slack(config.items);
+        int64_t model = MemoryStats::current(MemoryTag::Config) - config_before - slack;
+
+        std::printf("%5d items, depth %2d: %6.0f bytes/item (+%4.0f slack), peak yaml %8.1f KiB, config %8.1f KiB\n",
+                    loaded, shape.depth, static_cast<double>(model) / loaded, static_cast<double>(slack) / loaded,
+                    MemoryStats::peak(MemoryTag::Yaml) / 1024.0, MemoryStats::peak(MemoryTag::Config) / 1024.0);
+
+        CHECK(loaded == written);
+        CHECK(model <= BYTES_PER_ITEM * loaded);
+        CHECK(slack <= static_cast<int64_t>(sizeof(MenuItem)) * loaded);
+        CHECK(MemoryStats::current(MemoryTag::Yaml) == yaml_resident);
+        CHECK(MemoryStats::peak(MemoryTag::Yaml) <= FIXED_PEAK + YAML_PEAK_PER_ITEM * loaded);
+        CHECK(MemoryStats::peak(MemoryTag::Config) <= FIXED_PEAK + CONFIG_PEAK_PER_ITEM * loaded);
+    }
+
+    unlink(path);
+    return check_result();
+}
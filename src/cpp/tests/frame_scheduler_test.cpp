@@ -0,0 +1,124 @@
+// Frame slack scheduling without a frame clock (the idle-slice path)
+// Jobs run by priority then in posting order, cancelled ones are dropped,
+// unfinished ones keep their place, and other sources get a turn between
+// slices
+
+#include "check.hpp"
+#include "frame_scheduler.hpp"
+#include <glibmm/init.h>
+#include <glibmm/main.h>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        g_main_context_iteration(nullptr, FALSE);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+static Task await_slack(CancelToken token, SlackPriority priority, std::vector<std::string>* log,
+                        std::string name) {
+    co_await in_frame_slack(token, priority);
+    log->push_back(name);
+}
+
+int main() {
+    Glib::init();
+    auto& scheduler = FrameScheduler::instance();
+    CancelScope scope;
+    std::vector<std::string> log;
+
+    auto record = [&](std::string name) {
+        return [&log, name]() {
+            log.push_back(name);
+            return false;
+        };
+    };
+
+    // Priority first, then posting order
+    scheduler.post(SlackPriority::Speculative, scope.token(), record("speculative"));
+    scheduler.post(SlackPriority::Prefetch, scope.token(), record("prefetch 1"));
+    scheduler.post(SlackPriority::Visible, scope.token(), record("visible"));
+    scheduler.post(SlackPriority::Prefetch, scope.token(), record("prefetch 2"));
+    CHECK(log.empty());  // Nothing runs inside post()
+    CHECK(pump_until([&]() { return log.size() == 4; }));
+    CHECK((log == std::vector<std::string>{"visible", "prefetch 1", "prefetch 2", "speculative"}));
+
+    // Cancelled before its turn: dropped, the rest still run
+    log.clear();
+    {
+        CancelScope dropped;
+        scheduler.post(SlackPriority::Visible, dropped.token(), record("dropped"));
+        scheduler.post(SlackPriority::Visible, scope.token(), record("kept"));
+    }
+    CHECK(pump_until([&]() { return log.size() == 1; }));
+    CHECK((log == std::vector<std::string>{"kept"}));
+
+    // A job with more to do runs again before later posts of its priority
+    log.clear();
+    int rounds = 0;
+    scheduler.post(SlackPriority::Prefetch, scope.token(), [&]() {
+        log.push_back("round " + std::to_string(++rounds));
+        return rounds < 3;
+    });
+    scheduler.post(SlackPriority::Prefetch, scope.token(), record("later"));
+    CHECK(pump_until([&]() { return log.size() == 4; }));
+    CHECK((log == std::vector<std::string>{"round 1", "round 2", "round 3", "later"}));
+
+    // A throwing job is logged and skipped
+    log.clear();
+    scheduler.post(SlackPriority::Visible, scope.token(), []() -> bool {
+        throw std::runtime_error("job failed");
+    });
+    scheduler.post(SlackPriority::Visible, scope.token(), record("after failure"));
+    CHECK(pump_until([&]() { return log.size() == 1; }));
+    CHECK((log == std::vector<std::string>{"after failure"}));
+
+    // Jobs longer than a slice: other sources run after each one
+    int slow_runs = 0;
+    int runs_before_other = -1;
+    scheduler.post(SlackPriority::Visible, scope.token(), [&]() {
+        if (++slow_runs == 1) {
+            Glib::signal_idle().connect_once([&]() { runs_before_other = slow_runs; },
+                                             Glib::PRIORITY_DEFAULT);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(6));
+        return slow_runs < 5;
+    });
+    CHECK(pump_until([&]() { return slow_runs == 5; }));
+    CHECK(runs_before_other == 1);
+
+    // Coroutines resume in their turn, or never once cancelled
+    log.clear();
+    {
+        CancelScope dropped;
+        await_slack(dropped.token(), SlackPriority::Visible, &log, "dropped");
+        await_slack(scope.token(), SlackPriority::Speculative, &log, "speculative");
+        await_slack(scope.token(), SlackPriority::Visible, &log, "visible");
+    }
+    CHECK(log.empty());
+    CHECK(pump_until([&]() { return log.size() == 2; }));
+    CHECK((log == std::vector<std::string>{"visible", "speculative"}));
+
+    // Already cancelled: the coroutine is dropped at once
+    CancelScope cancelled;
+    cancelled.cancel();
+    await_slack(cancelled.token(), SlackPriority::Visible, &log, "never");
+    for (int i = 0; i < 20; ++i) {
+        g_main_context_iteration(nullptr, FALSE);
+    }
+    CHECK(log.size() == 2);
+
+    return check_result();
+}
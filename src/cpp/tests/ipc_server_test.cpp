@@ -0,0 +1,210 @@
+// Daemon socket: request parsing and its security policy, and the socket
+// itself (who may connect, stale and live sockets, a full round trip)
+// Desktop files come from a scratch XDG_DATA_HOME (GIO only loads those whose
+// Exec program exists, hence cat and rm)
+
+#include "check.hpp"
+#include "ipc_server.hpp"
+#include <giomm/init.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static void write_file(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+static bool exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+static bool parses(const std::string& line) {
+    IpcMenuRequest request;
+    std::string error;
+    return IpcServer::parse_request(line, request, error);
+}
+
+// Error of a request that must be refused (empty if it was accepted)
+static std::string refusal(const std::string& line) {
+    IpcMenuRequest request;
+    std::string error;
+    return IpcServer::parse_request(line, request, error) ? "" : error;
+}
+
+static std::string nested(int depth) {
+    std::string item = "{\"label\": \"leaf\", \"command\": \"true\"}";
+    for (int i = 0; i < depth; ++i) {
+        item = "{\"label\": \"level\", \"submenu\": [" + item + "]}";
+    }
+    return "{\"items\": [" + item + "]}";
+}
+
+static std::string flat(int count) {
+    std::string items;
+    for (int i = 0; i < count; ++i) {
+        items += std::string(i ? ", " : "") + "{\"label\": \"" + std::to_string(i) + "\"}";
+    }
+    return "{\"items\": [" + items + "]}";
+}
+
+// A socket file nobody listens on, as a crashed daemon leaves behind
+static bool leave_stale_socket(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    bool bound = bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    close(fd);
+    return bound;
+}
+
+// send_request() blocks, so it runs beside the main loop that serves it
+static std::string round_trip(const std::string& line, const std::string& path) {
+    std::string reply;
+    std::atomic<bool> done = false;
+    std::thread client([&]() {
+        if (!IpcServer::send_request(line, reply, path)) {
+            reply = "(failed)";
+        }
+        done = true;
+    });
+    pump_until([&]() { return done.load(); });
+    client.join();
+    return reply;
+}
+
+int main() {
+    char dir_template[] = "/tmp/radux-ipc-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        return SKIPPED;
+    }
+    std::string dir = dir_template;
+    std::string apps = dir + "/applications";
+    mkdir(apps.c_str(), 0700);
+    write_file(apps + "/org.radux.Editor.desktop",
+               "[Desktop Entry]\nType=Application\nName=Editor\nExec=cat %F\n");
+    write_file(apps + "/org.radux.Remove.desktop",
+               "[Desktop Entry]\nType=Application\nName=Remove\nExec=rm %F\n");
+    setenv("XDG_DATA_HOME", dir.c_str(), 1);
+    setenv("XDG_DATA_DIRS", dir.c_str(), 1);
+    Gio::init();
+
+    // A full request
+    IpcMenuRequest request;
+    std::string error;
+    CHECK(IpcServer::parse_request(
+        "{\"x\": 500, \"y\": 300, \"items\": [{\"id\": \"build\", \"label\": \"Build\", \"hotkey\": \"b\"},"
+        " {\"label\": \"Git\", \"submenu\": [{\"id\": \"pull\", \"label\": \"Pull\"}]}]}",
+        request, error));
+    CHECK(request.has_position && request.x == 500 && request.y == 300);
+    CHECK(request.items && request.items->size() == 2);
+    if (request.items && request.items->size() == 2) {
+        CHECK(request.items->at(0).id == "build");
+        CHECK(request.items->at(1).id == "Git");
+        CHECK(request.items->at(1).submenu.size() == 1);
+    }
+
+    // Without items: the configured menu
+    IpcMenuRequest empty;
+    CHECK(IpcServer::parse_request("{}", empty, error));
+    CHECK(!empty.items && !empty.has_position);
+
+    // Malformed requests
+    CHECK(refusal("[1, 2]") == "request must be an object");
+    CHECK(refusal("{\"items\": {}}") == "items must be an array");
+    CHECK(refusal("{\"items\": []}") == "items must not be empty");
+    CHECK(refusal("{\"items\": [{\"id\": \"x\"}]}") == "menu item missing label");
+    CHECK(refusal("{\"items\": [{\"label\": \"x\"}").rfind("malformed request", 0) == 0);
+
+    // Nesting and item count are bounded
+    CHECK(parses(nested(16)));
+    CHECK(refusal(nested(17)) == "submenu nesting too deep");
+    CHECK(parses(flat(4096)));
+    CHECK(refusal(flat(4097)) == "too many items");
+
+    // Commands follow the blacklist, in submenus too
+    CHECK(parses("{\"items\": [{\"label\": \"Edit\", \"command\": \"gedit notes.txt\"}]}"));
+    CHECK(!parses("{\"items\": [{\"label\": \"Wipe\", \"command\": \"rm -rf /tmp/x\"}]}"));
+    CHECK(!parses("{\"items\": [{\"label\": \"Chain\", \"command\": \"ls; gedit\"}]}"));
+    CHECK(!parses("{\"items\": [{\"label\": \"Menu\", \"submenu\": [{\"label\": \"Up\", \"command\": \"sudo ls\"}]}]}"));
+
+    // So do the Exec lines of desktop-id items, unless a command replaces them
+    CHECK(parses("{\"items\": [{\"label\": \"Editor\", \"desktop-id\": \"org.radux.Editor\"}]}"));
+    CHECK(!parses("{\"items\": [{\"label\": \"Remove\", \"desktop-id\": \"org.radux.Remove.desktop\"}]}"));
+    CHECK(parses("{\"items\": [{\"label\": \"Remove\", \"desktop-id\": \"org.radux.Remove\", \"command\": \"gedit\"}]}"));
+    CHECK(parses("{\"items\": [{\"label\": \"Gone\", \"desktop-id\": \"org.radux.Unknown\"}]}"));
+
+    // Replies are JSON, whatever the ID holds
+    MenuItem chosen("Quote \"me\"\n", "true");
+    chosen.id = "";
+    CHECK(IpcServer::format_reply(&chosen) == "{\"id\": \"Quote \\\"me\\\"\\n\"}");
+    CHECK(IpcServer::format_reply(nullptr) == "{\"id\": null}");
+    CHECK(IpcServer::format_error("bad\tinput") == "{\"error\": \"bad\\tinput\"}");
+
+    // Something other than a socket at the path is never removed
+    std::string path = dir + "/radux.sock";
+    auto answer = [](const IpcMenuRequest& request, const IpcServer::ReplyFunc& reply) {
+        reply(request.items ? &request.items->front() : nullptr);
+    };
+    write_file(path, "not a socket");
+    {
+        IpcServer server(path);
+        CHECK(!server.start(answer));
+    }
+    CHECK(exists(path));
+    unlink(path.c_str());
+
+    // A stale socket is replaced
+    CHECK(leave_stale_socket(path));
+    IpcServer server(path);
+    CHECK(server.start(answer));
+
+    // Only the owner may connect, from the moment the socket exists
+    struct stat info;
+    CHECK(stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode));
+    CHECK((info.st_mode & 0777) == 0700);
+
+    // Requests and replies, one line each
+    CHECK(round_trip("{\"items\": [{\"id\": \"pull\", \"label\": \"Pull\"}]}", path) == "{\"id\": \"pull\"}");
+    CHECK(round_trip("{}", path) == "{\"id\": null}");
+    CHECK(round_trip("{\"items\": [{\"label\": \"x\", \"command\": \"rm x\"}]}", path).rfind("{\"error\": ", 0) == 0);
+
+    // A live daemon keeps its socket
+    {
+        IpcServer second(path);
+        CHECK(!second.start(answer));
+    }
+    CHECK(round_trip("{\"items\": [{\"label\": \"Still here\"}]}", path) == "{\"id\": \"Still here\"}");
+
+    server.stop();
+    CHECK(!exists(path));
+
+    unlink((apps + "/org.radux.Editor.desktop").c_str());
+    unlink((apps + "/org.radux.Remove.desktop").c_str());
+    rmdir(apps.c_str());
+    rmdir(dir.c_str());
+    return check_result();
+}
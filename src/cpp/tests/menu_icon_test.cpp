@@ -0,0 +1,159 @@
+// Menu icons: decoded on the worker pool, never while painting, and kept in
+// the icon cache together with the copies scaled for drawing
+// Needs a display (run under xvfb-run); icons are PNGs in a scratch HOME
+
+#include "check.hpp"
+#include "radial_menu.hpp"
+#include "worker_pool.hpp"
+#include <gtkmm.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <unistd.h>
+
+// Jobs that keep every worker busy (the pool has at most 4 threads)
+static const int POOL_THREADS_MAX = 4;
+
+// Reaches the icon state of a menu (a friend of RadialMenu)
+class MenuIconProbe {
+public:
+    static bool cached(RadialMenu& menu, const std::string& path) {
+        return menu.icon_cache_.count(path) > 0;
+    }
+
+    static Glib::RefPtr<Gdk::Pixbuf> decoded(RadialMenu& menu, const std::string& path) {
+        auto it = menu.icon_cache_.find(path);
+        return it == menu.icon_cache_.end() ? Glib::RefPtr<Gdk::Pixbuf>() : it->second.pixbuf;
+    }
+
+    static size_t scaled_copies(RadialMenu& menu, const std::string& path) {
+        auto it = menu.icon_cache_.find(path);
+        return it == menu.icon_cache_.end() ? 0 : it->second.scaled.size();
+    }
+
+    static Glib::RefPtr<Gdk::Pixbuf> scaled(RadialMenu& menu, const std::string& path, double size) {
+        return menu.scaled_icon(path, size);
+    }
+
+    static bool draw(RadialMenu& menu, const std::string& path, double size) {
+        auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, 64, 64);
+        return menu.draw_icon(Cairo::Context::create(surface), 32, 32, path, size);
+    }
+};
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Run the main loop a little longer (for things that must not happen)
+static void settle() {
+    pump_until([start = std::chrono::steady_clock::now()]() {
+        return std::chrono::steady_clock::now() - start > std::chrono::milliseconds(300);
+    });
+}
+
+static std::string write_icon(const std::string& dir, const std::string& name, int width, int height) {
+    std::string path = dir + "/" + name;
+    auto pixbuf = Gdk::Pixbuf::create(Gdk::Colorspace::RGB, true, 8, width, height);
+    pixbuf->fill(0x3366ccff);
+    pixbuf->save(path, "png");
+    return path;
+}
+
+static void run(const std::string& dir) {
+    std::string square = write_icon(dir, "square.png", 64, 64);
+    std::string wide = write_icon(dir, "wide.png", 64, 32);
+    std::string missing = dir + "/missing.png";
+
+    // Hold every worker, so nothing can be decoded yet
+    std::atomic<bool> release = false;
+    for (int i = 0; i < POOL_THREADS_MAX; ++i) {
+        WorkerPool::instance().submit([&release]() {
+            while (!release) {
+                usleep(1000);
+            }
+        });
+    }
+
+    RadialConfig config;
+    config.breadcrumbs = false;
+    for (const auto& icon : {square, wide, missing}) {
+        MenuItem item(icon, "true");
+        item.icon = icon;
+        config.items.push_back(item);
+    }
+    RadialMenu menu(config);
+
+    // Looked up in frame slack, but waiting on the worker: painting draws
+    // labels meanwhile and decodes nothing itself
+    settle();
+    CHECK(!MenuIconProbe::cached(menu, square));
+    CHECK(!MenuIconProbe::draw(menu, square, 32));
+    CHECK(!MenuIconProbe::cached(menu, square));
+
+    // Workers free: every icon lands in the cache, a missing one as empty
+    release = true;
+    CHECK(pump_until([&]() {
+        return MenuIconProbe::cached(menu, square) && MenuIconProbe::cached(menu, wide) &&
+               MenuIconProbe::cached(menu, missing);
+    }));
+    auto decoded = MenuIconProbe::decoded(menu, square);
+    CHECK(decoded && decoded->get_width() == 64 && decoded->get_height() == 64);
+    CHECK(!MenuIconProbe::decoded(menu, missing));
+    CHECK(MenuIconProbe::draw(menu, square, 32));
+    CHECK(!MenuIconProbe::draw(menu, missing, 32));
+
+    // Scaled once per size and reused by later frames
+    CHECK(MenuIconProbe::scaled_copies(menu, square) == 1);
+    auto small = MenuIconProbe::scaled(menu, square, 32);
+    CHECK(small && small->get_width() == 32 && small->get_height() == 32);
+    CHECK(MenuIconProbe::scaled(menu, square, 32) == small);
+    CHECK(MenuIconProbe::draw(menu, square, 32));
+    CHECK(MenuIconProbe::scaled_copies(menu, square) == 1);
+    CHECK(MenuIconProbe::scaled(menu, square, 24) != small);
+    CHECK(MenuIconProbe::scaled_copies(menu, square) == 2);
+
+    // Drawn at its own size: the decoded icon itself, no copy
+    CHECK(MenuIconProbe::scaled(menu, square, 64) == decoded);
+    CHECK(MenuIconProbe::scaled_copies(menu, square) == 2);
+
+    // The aspect ratio is kept
+    auto wide_small = MenuIconProbe::scaled(menu, wide, 32);
+    CHECK(wide_small && wide_small->get_width() == 32 && wide_small->get_height() == 16);
+}
+
+int main(int argc, char** argv) {
+    char dir_template[] = "/tmp/radux-icons-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        return SKIPPED;
+    }
+    std::string dir = dir_template;
+    setenv("HOME", dir.c_str(), 1);
+
+    auto app = Gtk::Application::create("com.github.raduxmenu.icontest", Gio::Application::Flags::NON_UNIQUE);
+    bool ran = false;
+    app->signal_activate().connect([&]() {
+        ran = true;
+        run(dir);
+    });
+    app->run(argc, argv);
+    if (!ran) {
+        std::cerr << "No display, skipping\n";
+        return SKIPPED;
+    }
+
+    CHECK(std::system(("rm -rf " + dir).c_str()) == 0);
+    return check_result();
+}
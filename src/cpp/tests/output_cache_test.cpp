@@ -0,0 +1,264 @@
+// Output cache: previews, refresh by age, the byte caps, entries on disk,
+// loading them off the GTK thread, and pruning old ones
+// Runs in a scratch XDG_CACHE_HOME with a notify-send stand-in on PATH that
+// records each notification body
+
+#include "check.hpp"
+#include "output_cache.hpp"
+#include <giomm/init.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string dir;
+
+static void write_file(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Bodies notify-send was called with, oldest first
+static std::vector<std::string> notifications() {
+    std::vector<std::string> bodies;
+    std::istringstream lines(read_file(dir + "/notified"));
+    for (std::string line; std::getline(lines, line);) {
+        bodies.push_back(line);
+    }
+    return bodies;
+}
+
+// Files in the cache directory
+static std::vector<std::string> cache_files() {
+    std::vector<std::string> files;
+    std::string output_dir = dir + "/cache/radux/output";
+    DIR* handle = opendir(output_dir.c_str());
+    if (!handle) {
+        return files;
+    }
+    while (dirent* entry = readdir(handle)) {
+        if (entry->d_name[0] != '.') {
+            files.push_back(output_dir + "/" + entry->d_name);
+        }
+    }
+    closedir(handle);
+    return files;
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Run the main loop a little longer (for things that must not happen)
+static void settle() {
+    pump_until([start = std::chrono::steady_clock::now()]() {
+        return std::chrono::steady_clock::now() - start > std::chrono::milliseconds(300);
+    });
+}
+
+static bool cached(const std::string& command, const std::string& output) {
+    const OutputCache::Entry* entry = OutputCache::instance().lookup(command);
+    return entry && entry->output == output;
+}
+
+// A file in the cache directory, last modified age_seconds ago
+static void plant(const std::string& name, long age_seconds) {
+    std::string path = dir + "/cache/radux/output/" + name;
+    write_file(path, "planted");
+    timeval times[2] = {{time(nullptr) - age_seconds, 0}, {time(nullptr) - age_seconds, 0}};
+    utimes(path.c_str(), times);
+}
+
+static bool has_cache_file(const std::string& name) {
+    return access((dir + "/cache/radux/output/" + name).c_str(), F_OK) == 0;
+}
+
+// A fresh process, which can only know the entry from disk; mode is
+// --lookup (read at once) or --preload (read on the worker)
+// Returns 0 if it finds output, 1 if it finds something else, 2 if nothing
+static int lookup_in_new_process(const std::string& command, const std::string& output,
+                                 const char* mode = "--lookup") {
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/proc/self/exe", "output_cache_test", mode, command.c_str(), output.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && std::string(argv[1]) == "--lookup") {
+        const OutputCache::Entry* entry = OutputCache::instance().lookup(argv[2]);
+        return entry ? (entry->output == argv[3] ? 0 : 1) : 2;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--preload") {
+        // Painting only looks in memory; the disk is read on the worker
+        Gio::init();
+        auto& cache = OutputCache::instance();
+        CancelScope scope;
+        bool loaded = false;
+        cache.preload(scope.token(), argv[2], [&]() { loaded = true; });
+        if (cache.cached(argv[2]) || !pump_until([&]() { return loaded; })) {
+            return 2;
+        }
+        const OutputCache::Entry* entry = cache.cached(argv[2]);
+        return entry ? (entry->output == argv[3] ? 0 : 1) : 2;
+    }
+
+    // Preview: three lines of at most 40 characters, cut between code points
+    CHECK(OutputCache::preview("") == "");
+    CHECK(OutputCache::preview("one\ntwo") == "one\ntwo");
+    CHECK(OutputCache::preview("one\ntwo\n") == "one\ntwo");
+    CHECK(OutputCache::preview("1\n2\n3\n4\n5") == "1\n2\n3");
+    CHECK(OutputCache::preview(std::string(50, 'a')) == std::string(37, 'a') + "...");
+    std::string accents;
+    for (int i = 0; i < 50; ++i) {
+        accents += "\xC3\xA9";  // é
+    }
+    std::string shortened;
+    for (int i = 0; i < 37; ++i) {
+        shortened += "\xC3\xA9";
+    }
+    CHECK(OutputCache::preview(accents) == shortened + "...");
+
+    char dir_template[] = "/tmp/radux-output-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        return SKIPPED;
+    }
+    dir = dir_template;
+    std::string bin = dir + "/bin";
+    mkdir(bin.c_str(), 0700);
+    write_file(bin + "/notify-send", "#!/bin/sh\nprintf '%s\\n' \"$2\" >> " + dir + "/notified\n");
+    chmod((bin + "/notify-send").c_str(), 0700);
+
+    // Set before the cache is created: PATH is also part of every key
+    setenv("XDG_CACHE_HOME", (dir + "/cache").c_str(), 1);
+    setenv("PATH", (bin + ":/usr/bin:/bin").c_str(), 1);
+    Gio::init();
+
+    auto& cache = OutputCache::instance();
+    std::string source = dir + "/source";
+    std::string command = "cat " + source;
+    write_file(source, "first");
+
+    // Nothing cached: the notification waits for the command
+    CHECK(cache.lookup(command) == nullptr);
+    cache.run("Label", command, 3600);
+    CHECK(pump_until([&]() { return notifications().size() == 1; }));
+    CHECK((notifications() == std::vector<std::string>{"first"}));
+    CHECK(cached(command, "first"));
+    CHECK(cache_files().size() == 1);
+
+    // Fresh entry: answered from the cache, the command does not run
+    write_file(source, "second");
+    cache.run("Label", command, 3600);
+    CHECK(pump_until([&]() { return notifications().size() == 2; }));
+    settle();
+    CHECK((notifications() == std::vector<std::string>{"first", "first"}));
+    CHECK(cached(command, "first"));
+
+    // Stale entry: the old output now, the new one stored for next time
+    cache.run("Label", command, 0);
+    CHECK(pump_until([&]() { return cached(command, "second") && notifications().size() == 3; }));
+    settle();
+    CHECK((notifications() == std::vector<std::string>{"first", "first", "first"}));
+
+    // Another process reads the entry from disk
+    CHECK(lookup_in_new_process(command, "second") == 0);
+    CHECK(lookup_in_new_process("cat " + dir + "/other", "") == 2);
+    CHECK(lookup_in_new_process(command, "second", "--preload") == 0);
+
+    // A different environment is a different entry
+    setenv("LANG", "radux-test", 1);
+    CHECK(cache.lookup(command) == nullptr);
+    CHECK(lookup_in_new_process(command, "second") == 2);
+    unsetenv("LANG");
+
+    // A damaged file is ignored, not misread
+    auto files = cache_files();
+    CHECK(files.size() == 1);
+    if (files.size() == 1) {
+        std::string stored = read_file(files.front());
+        write_file(files.front(), stored.substr(0, stored.find('\n')));
+        CHECK(lookup_in_new_process(command, "second") == 2);
+        write_file(files.front(), "garbage");
+        CHECK(lookup_in_new_process(command, "second") == 2);
+        write_file(files.front(), stored);
+        CHECK(lookup_in_new_process(command, "second") == 0);
+    }
+
+    // A failing command stores nothing and stays quiet
+    std::string failing = "false";
+    cache.run("Fail", failing, 3600);
+    settle();
+    CHECK(cache.lookup(failing) == nullptr);
+    CHECK(notifications().size() == 3);
+
+    // Output is kept up to 64 KiB; the notification gets 500 characters
+    std::string big = dir + "/big";
+    write_file(big, std::string(100000, 'x'));
+    cache.run("Big", "cat " + big, 3600);
+    CHECK(pump_until([&]() { return notifications().size() == 4; }));
+    const OutputCache::Entry* entry = cache.lookup("cat " + big);
+    CHECK(entry && entry->output.size() == 64 * 1024);
+    CHECK(notifications().size() == 4 && notifications().back() == std::string(497, 'x') + "...");
+
+    // Storing an entry prunes the directory: entries older than 30 days and
+    // abandoned temporary files go, then the oldest beyond 256 entries
+    const int MAX_ENTRIES = 256;
+    plant("00000000000000aa", 31 * 24 * 60 * 60);
+    plant("00000000000000ab.tmp", 3600);
+    plant("00000000000000ac.tmp", 0);
+    plant("notes.txt", 365 * 24 * 60 * 60);
+    for (int i = 0; i < MAX_ENTRIES; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016x", static_cast<unsigned>(0x1000 + i));
+        plant(name, (MAX_ENTRIES - i) * 60);
+    }
+    std::string third = dir + "/third";
+    write_file(third, "third");
+    cache.run("Third", "cat " + third, 3600);
+    CHECK(pump_until([&]() { return notifications().size() == 5; }));
+    CHECK(!has_cache_file("00000000000000aa"));
+    CHECK(!has_cache_file("00000000000000ab.tmp"));
+    CHECK(has_cache_file("00000000000000ac.tmp"));
+    CHECK(has_cache_file("notes.txt"));
+    // Two earlier entries and the new one push out the three oldest planted
+    CHECK(!has_cache_file("0000000000001000") && !has_cache_file("0000000000001002"));
+    CHECK(has_cache_file("0000000000001003") && has_cache_file("00000000000010ff"));
+    CHECK(cache_files().size() == MAX_ENTRIES + 2);
+    CHECK(lookup_in_new_process(command, "second") == 0);
+    CHECK(lookup_in_new_process("cat " + third, "third") == 0);
+
+    CHECK(std::system(("rm -rf " + dir).c_str()) == 0);
+    return check_result();
+}
@@ -0,0 +1,187 @@
+// Provider plugins through the C ABI: loading, item fields, streaming,
+// cancellation, caching, and exit while a plugin ignores cancellation
+// The plugins are builds of test_plugin.cpp in RADUX_TEST_PLUGIN_DIR
+
+#include "check.hpp"
+#include "menu_provider.hpp"
+#include <glibmm/init.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <string>
+#include <vector>
+#include <dlfcn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const std::string PLUGIN_DIR = RADUX_TEST_PLUGIN_DIR;
+
+// Counter exported by one of the loaded test plugins
+static std::atomic<int>& counter(const std::string& plugin, const char* name) {
+    static std::atomic<int> missing{-1};
+    void* handle = dlopen((PLUGIN_DIR + "/" + plugin + ".so").c_str(), RTLD_NOW | RTLD_NOLOAD);
+    void* symbol = handle ? dlsym(handle, name) : nullptr;
+    if (handle) {
+        dlclose(handle);  // Only drops the reference taken just now
+    }
+    return symbol ? *static_cast<std::atomic<int>*>(symbol) : missing;
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Run the main loop a little longer (for things that must not happen)
+static void settle() {
+    pump_until([start = std::chrono::steady_clock::now()]() {
+        return std::chrono::steady_clock::now() - start > std::chrono::milliseconds(300);
+    });
+}
+
+static std::vector<std::string> labels(const std::vector<MenuItem>& items) {
+    std::vector<std::string> result;
+    for (const auto& item : items) {
+        result.push_back(item.label);
+    }
+    return result;
+}
+
+// Child: start a fetch that never returns, cancel it and exit
+static int run_stuck() {
+    Glib::init();
+    auto& registry = ProviderRegistry::instance();
+    registry.load_plugins(PLUGIN_DIR);
+    auto request = registry.request("stream", "stuck");
+    pump_until([]() { return counter("radux_test_stream", "radux_test_fetches") == 1; });
+    registry.cancel_all();
+    return 0;
+}
+
+// The child must be gone well before the test times out
+static bool exits_promptly() {
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/proc/self/exe", "provider_plugin_test", "--stuck", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    int status = 0;
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+            return false;
+        }
+        usleep(10000);
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && std::string(argv[1]) == "--stuck") {
+        return run_stuck();
+    }
+
+    Glib::init();
+    auto& registry = ProviderRegistry::instance();
+    registry.load_plugins(PLUGIN_DIR);
+
+    // Matching ABI versions are loaded, others refused
+    CHECK(registry.has("stream"));
+    CHECK(registry.has("session"));
+    CHECK(!registry.has("old"));
+    auto& fetches = counter("radux_test_stream", "radux_test_fetches");
+    CHECK(fetches == 0);
+
+    // Every field crosses the boundary; priority is clamped, NULL is unset,
+    // items without a label are dropped
+    auto fields = registry.request("stream", "fields");
+    CHECK(pump_until([&]() { return fields->is_done(); }));
+    CHECK(fields->items().size() == 2);
+    if (fields->items().size() == 2) {
+        const MenuItem& full = fields->items()[0];
+        CHECK(full.label == "Label");
+        CHECK(full.command == "echo hi");
+        CHECK(full.description == "Description");
+        CHECK(full.icon == std::optional<std::string>("icon-name"));
+        CHECK(full.hotkey == std::optional<std::string>("h"));
+        CHECK(full.provider == "nested" && full.provider_arg == "nested-arg");
+        CHECK(full.priority == 10);
+        const MenuItem& bare = fields->items()[1];
+        CHECK(bare.label == "Bare" && bare.command.empty() && bare.description.empty());
+        CHECK(!bare.icon && !bare.hotkey && bare.provider.empty());
+        CHECK(bare.priority == 0);
+    }
+
+    // Items show up while the plugin is still running
+    std::vector<std::string> streamed;
+    bool streamed_done = false;
+    auto stream = registry.request("stream", "stream");
+    stream->subscribe([&](const std::vector<MenuItem>& batch) {
+        auto batch_labels = labels(batch);
+        streamed.insert(streamed.end(), batch_labels.begin(), batch_labels.end());
+    }, [&]() { streamed_done = true; });
+    CHECK(pump_until([&]() { return streamed == std::vector<std::string>{"first"}; }));
+    CHECK(!streamed_done);
+    counter("radux_test_stream", "radux_test_gate") = 1;
+    CHECK(pump_until([&]() { return streamed_done; }));
+    CHECK((streamed == std::vector<std::string>{"first", "second"}));
+
+    // Cancelling stops the plugin and silences the request
+    int callbacks = 0;
+    int before = fetches;
+    auto waiting = registry.request("stream", "wait");
+    waiting->subscribe([&](const std::vector<MenuItem>&) { ++callbacks; }, [&]() { ++callbacks; });
+    CHECK(pump_until([&]() { return fetches == before + 1; }));
+    waiting->cancel();
+    CHECK(pump_until([&]() { return counter("radux_test_stream", "radux_test_cancel_seen") == 1; }));
+    CHECK(counter("radux_test_stream", "radux_test_emit_refused") == 1);
+    settle();
+    CHECK(callbacks == 0);
+
+    // The cancelled fetch is not joined: asking again starts another
+    counter("radux_test_stream", "radux_test_cancel_seen") = 0;
+    auto again = registry.request("stream", "wait");
+    CHECK(again != waiting);
+    CHECK(pump_until([&]() { return fetches == before + 2; }));
+    again->cancel();
+    CHECK(pump_until([&]() { return counter("radux_test_stream", "radux_test_cancel_seen") == 1; }));
+
+    // Uncached: every request fetches
+    before = fetches;
+    auto first = registry.request("stream", "plain");
+    CHECK(pump_until([&]() { return first->is_done(); }));
+    auto second = registry.request("stream", "plain");
+    CHECK(pump_until([&]() { return second->is_done(); }));
+    CHECK(fetches == before + 2);
+
+    // Session cache: one fetch, joined while it runs, then answered at once
+    auto& session_fetches = counter("radux_test_session", "radux_test_fetches");
+    auto running = registry.request("session", "x");
+    CHECK(registry.request("session", "x") == running);
+    CHECK(pump_until([&]() { return running->is_done(); }));
+    auto cached = registry.request("session", "x");
+    CHECK(cached->is_done());
+    CHECK((labels(cached->items()) == std::vector<std::string>{"x"}));
+    CHECK(session_fetches == 1);
+    registry.invalidate("session", "x");
+    auto refetched = registry.request("session", "x");
+    CHECK(pump_until([&]() { return refetched->is_done(); }));
+    CHECK(session_fetches == 2);
+
+    // A plugin that never returns does not hold up exit
+    CHECK(exits_promptly());
+
+    return check_result();
+}
@@ -0,0 +1,159 @@
+// Recent documents: frecency ranking, reuse of the parsed ranking, and the
+// answer from the previous ranking while a changed file is ranked again
+// Runs in a scratch XDG_DATA_HOME whose recently-used.xbel points at real files
+
+#include "check.hpp"
+#include "recent_provider.hpp"
+#include <glibmm/init.h>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::string dir;
+
+struct Bookmark {
+    std::string name;  // File in dir ("" for a URI that is not a file)
+    int days_ago;
+    int count;
+};
+
+static std::string iso_time(int days_ago) {
+    time_t when = std::time(nullptr) - static_cast<time_t>(days_ago) * 86400;
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&when));
+    return buffer;
+}
+
+// Write the history; mtime_seconds (if not 0) pins the file's mtime
+static void write_history(const std::vector<Bookmark>& bookmarks, time_t mtime_seconds = 0) {
+    std::string path = dir + "/recently-used.xbel";
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+             << "<xbel version=\"1.0\" xmlns:bookmark=\"http://www.freedesktop.org/standards/desktop-bookmarks\""
+             << " xmlns:mime=\"http://www.freedesktop.org/standards/shared-mime-info\">\n";
+        for (const auto& bookmark : bookmarks) {
+            std::string uri = bookmark.name.empty() ? "https://example.org/" : "file://" + dir + "/" + bookmark.name;
+            std::string time = iso_time(bookmark.days_ago);
+            file << "  <bookmark href=\"" << uri << "\" added=\"" << time << "\" modified=\"" << time
+                 << "\" visited=\"" << time << "\">\n"
+                 << "    <info><metadata owner=\"http://freedesktop.org\">\n"
+                 << "      <mime:mime-type type=\"text/plain\"/>\n"
+                 << "      <bookmark:applications>\n"
+                 << "        <bookmark:application name=\"editor\" exec=\"editor %u\" modified=\"" << time
+                 << "\" count=\"" << bookmark.count << "\"/>\n"
+                 << "      </bookmark:applications>\n"
+                 << "    </metadata></info>\n"
+                 << "  </bookmark>\n";
+        }
+        file << "</xbel>\n";
+    }
+    if (mtime_seconds != 0) {
+        struct timespec times[2] = {{mtime_seconds, 0}, {mtime_seconds, 0}};
+        utimensat(AT_FDCWD, path.c_str(), times, 0);
+    }
+}
+
+static void touch(const std::string& name) {
+    std::ofstream file(dir + "/" + name);
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Labels of one complete fetch (the registry's own cache is bypassed)
+static std::vector<std::string> fetch(const std::string& arg = "") {
+    auto& registry = ProviderRegistry::instance();
+    registry.invalidate("recent", arg);
+    auto request = registry.request("recent", arg);
+    std::vector<std::string> labels;
+    if (!pump_until([&]() { return request->is_done(); })) {
+        return {"(timed out)"};
+    }
+    for (const auto& item : request->items()) {
+        labels.push_back(item.label);
+    }
+    return labels;
+}
+
+int main() {
+    char dir_template[] = "/tmp/radux-recent-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        return SKIPPED;
+    }
+    dir = dir_template;
+    setenv("XDG_DATA_HOME", dir.c_str(), 1);
+    Glib::init();
+
+    for (const char* name : {"a.txt", "b.txt", "c.txt", "d.txt", "e.txt"}) {
+        touch(name);
+    }
+
+    auto& registry = ProviderRegistry::instance();
+    registry.add("recent", std::make_shared<RecentProvider>("xdg-open", 10));
+    int refreshes = 0;
+    registry.add_change_listener([&](const std::string& name) {
+        if (name == "recent") {
+            ++refreshes;
+        }
+    });
+
+    // No history yet
+    CHECK(fetch().empty());
+
+    // Uses weighted by age: 10 uses two months ago (300) beat 3 uses last
+    // week (210) and one use today (100); a year-old use scores 10. Equal
+    // scores go to the more recent. Missing files and web pages are left out
+    time_t first_mtime = std::time(nullptr) - 100;
+    write_history({{"d.txt", 400, 1}, {"a.txt", 1, 1}, {"b.txt", 10, 3}, {"c.txt", 60, 10},
+                   {"gone.txt", 0, 50}, {"", 0, 50}, {"e.txt", 2, 1}},
+                  first_mtime);
+    CHECK((fetch() == std::vector<std::string>{"c.txt", "b.txt", "a.txt", "e.txt", "d.txt"}));
+    CHECK((fetch("2") == std::vector<std::string>{"c.txt", "b.txt"}));
+    CHECK(refreshes == 0);
+
+    // Same mtime and size: the parsed ranking is reused, the file is not read
+    write_history({{"d.txt", 400, 1}, {"a.txt", 1, 9}, {"b.txt", 10, 3}, {"c.txt", 60, 10},
+                   {"gone.txt", 0, 50}, {"", 0, 50}, {"e.txt", 2, 1}},
+                  first_mtime);
+    CHECK((fetch() == std::vector<std::string>{"c.txt", "b.txt", "a.txt", "e.txt", "d.txt"}));
+    CHECK(refreshes == 0);
+
+    // Changed file: the previous ranking answers at once; the new one
+    // follows in the background and open menus are told to fetch again
+    write_history({{"d.txt", 0, 40}, {"a.txt", 1, 1}, {"b.txt", 10, 3}, {"c.txt", 60, 10},
+                   {"e.txt", 2, 1}},
+                  first_mtime + 10);
+    CHECK((fetch() == std::vector<std::string>{"c.txt", "b.txt", "a.txt", "e.txt", "d.txt"}));
+    CHECK(pump_until([&]() { return refreshes == 1; }));
+    CHECK((fetch() == std::vector<std::string>{"d.txt", "c.txt", "b.txt", "a.txt", "e.txt"}));
+    CHECK(refreshes == 1);
+
+    // A file deleted since the ranking drops out without a re-rank
+    unlink((dir + "/b.txt").c_str());
+    CHECK((fetch() == std::vector<std::string>{"d.txt", "c.txt", "a.txt", "e.txt"}));
+
+    for (const char* name : {"a.txt", "c.txt", "d.txt", "e.txt", "recently-used.xbel"}) {
+        unlink((dir + "/" + name).c_str());
+    }
+    rmdir(dir.c_str());
+    return check_result();
+}
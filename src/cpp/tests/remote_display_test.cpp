@@ -0,0 +1,239 @@
+// Remote X11 sessions: the X traffic of summoning a menu, over a slow link
+// (run under xvfb-run with access control off, see tests/CMakeLists.txt)
+// A local TCP proxy in front of the X server holds every reply back by
+// DELAY_MS, as SSH forwarding over a distant link does; the time a call takes
+// then tells how many round trips it waited for
+
+#include "check.hpp"
+#include "platform_Utilities.hpp"
+#include <gtk/gtk.h>
+#include <gdk/x11/gdkx.h>
+#include <X11/Xlib.h>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const int DELAY_MS = 100;
+
+// One call that waits for a single reply stays under this; two cannot
+static const int ONE_ROUND_TRIP_MS = DELAY_MS * 17 / 10;
+
+// Calls that wait for no reply stay under this
+static const int NO_ROUND_TRIP_MS = DELAY_MS / 2;
+
+static bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Requests go straight through; replies and events leave DELAY_MS after they
+// arrived, so pipelined replies still share one delay
+static void relay(int client, int server) {
+    struct Chunk {
+        std::chrono::steady_clock::time_point due;
+        std::string data;
+    };
+    std::deque<Chunk> replies;
+    char buffer[65536];
+
+    for (;;) {
+        int timeout = -1;
+        if (!replies.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                replies.front().due - std::chrono::steady_clock::now()).count();
+            timeout = wait > 0 ? static_cast<int>(wait) : 0;
+        }
+        pollfd fds[2] = {{client, POLLIN, 0}, {server, POLLIN, 0}};
+        if (poll(fds, 2, timeout) < 0) {
+            break;
+        }
+        if (fds[0].revents) {
+            ssize_t size = read(client, buffer, sizeof(buffer));
+            if (size <= 0 || !write_all(server, buffer, static_cast<size_t>(size))) {
+                break;
+            }
+        }
+        if (fds[1].revents) {
+            ssize_t size = read(server, buffer, sizeof(buffer));
+            if (size <= 0) {
+                break;
+            }
+            replies.push_back({std::chrono::steady_clock::now() + std::chrono::milliseconds(DELAY_MS),
+                               std::string(buffer, static_cast<size_t>(size))});
+        }
+        while (!replies.empty() && replies.front().due <= std::chrono::steady_clock::now()) {
+            if (!write_all(client, replies.front().data.data(), replies.front().data.size())) {
+                break;
+            }
+            replies.pop_front();
+        }
+    }
+    close(client);
+    close(server);
+}
+
+// Listen on TCP display number 6000 + n in front of the local X server
+// Returns the display name to use, or "" if the proxy could not start
+static std::string start_proxy(const std::string& local_display) {
+    // Only ":N" and ":N.S" are served by /tmp/.X11-unix/XN
+    if (local_display.size() < 2 || local_display[0] != ':') {
+        return "";
+    }
+    std::string socket_path = "/tmp/.X11-unix/X" + local_display.substr(1, local_display.find('.') - 1);
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int number = 0;
+    for (number = 50; number < 100; ++number) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(6000 + number));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            break;
+        }
+    }
+    if (number == 100 || listen(listener, 8) != 0) {
+        close(listener);
+        return "";
+    }
+
+    std::thread([listener, socket_path]() {
+        for (;;) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                return;
+            }
+            int server = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            socket_path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+            if (connect(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(server);
+                close(client);
+                continue;
+            }
+            std::thread(relay, client, server).detach();
+        }
+    }).detach();
+
+    return "127.0.0.1:" + std::to_string(number);
+}
+
+static long elapsed_ms(const std::function<void()>& call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+int main() {
+    const char* local = std::getenv("DISPLAY");
+    std::string local_display = local ? local : "";
+    std::string remote_display = start_proxy(local_display);
+    if (remote_display.empty()) {
+        std::cerr << "No local X server to put the proxy in front of, skipping\n";
+        return SKIPPED;
+    }
+
+    // Everything from here on talks to the X server through the proxy
+    setenv("DISPLAY", remote_display.c_str(), 1);
+    setenv("GDK_BACKEND", "x11", 1);
+    setenv("GSK_RENDERER", "cairo", 1);
+    unsetenv("WAYLAND_DISPLAY");
+    gtk_init();
+    GdkDisplay* gdk_display = gdk_display_get_default();
+    if (!gdk_display || !GDK_IS_X11_DISPLAY(gdk_display)) {
+        std::cerr << "Cannot reach the X server through the proxy, skipping\n";
+        return SKIPPED;
+    }
+
+    PlatformDisplay platform;
+    CHECK(platform.is_remote());
+
+    GtkWidget* window = gtk_window_new();
+    gtk_window_set_default_size(GTK_WINDOW(window), 100, 100);
+    gtk_window_present(GTK_WINDOW(window));
+    GdkSurface* surface = gtk_native_get_surface(GTK_NATIVE(window));
+    CHECK(surface != nullptr);
+    pump_until([&]() { return gdk_surface_get_mapped(surface); });
+
+    // The link is slow: each blocking query waits out the delay
+    int x = 0, y = 0;
+    long calibration = elapsed_ms([&]() {
+        platform.get_pointer_position(x, y);
+        platform.get_pointer_position(x, y);
+    });
+    CHECK(calibration >= 2 * DELAY_MS);
+
+    // Summon at the pointer: pointer and monitors in one round trip
+    CHECK(platform.warp_pointer(640, 512));
+    MonitorGeometry monitor;
+    bool found = false;
+    long summon = elapsed_ms([&]() { found = platform.query_pointer_and_monitor(x, y, monitor); });
+    CHECK(found);
+    CHECK(x == 640 && y == 512);
+    CHECK(monitor.contains(x, y));
+    CHECK(summon < ONE_ROUND_TRIP_MS);
+
+    // Summon at a given position: the monitors alone, one round trip
+    long at_position = elapsed_ms([&]() { found = platform.get_monitor_at(10, 10, monitor); });
+    CHECK(found);
+    CHECK(monitor.contains(10, 10));
+    CHECK(at_position < ONE_ROUND_TRIP_MS);
+
+    // Placing the window waits for nothing
+    bool moved = false;
+    long placing = elapsed_ms([&]() { moved = platform.move_surface(surface, 200, 150); });
+    CHECK(moved);
+    CHECK(placing < NO_ROUND_TRIP_MS);
+
+    // ...and the window really moved (seen on a direct connection)
+    Display* direct = XOpenDisplay(local_display.c_str());
+    CHECK(direct != nullptr);
+    if (direct) {
+        Window xid = gdk_x11_surface_get_xid(surface);
+        CHECK(pump_until([&]() {
+            int root_x = 0, root_y = 0;
+            Window child = None;
+            XTranslateCoordinates(direct, xid, DefaultRootWindow(direct), 0, 0, &root_x, &root_y, &child);
+            return root_x == 200 && root_y == 150;
+        }));
+        XCloseDisplay(direct);
+    }
+
+    std::cerr << "Round trips over a " << DELAY_MS << " ms link: two queries " << calibration
+              << " ms, summon at pointer " << summon << " ms, at position " << at_position
+              << " ms, place window " << placing << " ms\n";
+
+    gtk_window_destroy(GTK_WINDOW(window));
+    return check_result();
+}
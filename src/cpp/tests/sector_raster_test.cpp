@@ -0,0 +1,170 @@
+// Analytic wedges against Cairo's own rendering of the same path
+// Both draw into ARGB32 buffers; every channel of every pixel must agree to
+// within MAX_CHANNEL_DELTA. Only the corners get more slack: there the
+// distance field and Cairo's scan converter antialias differently
+// Cairo flattens arcs finely here, so the reference is close to the exact
+// shape and the bounds measure the analytic renderer. Against 16x16 samples
+// per pixel of that shape it is off by at most 18 (56 at corners); the rest
+// is room for Cairo's 15 sample rows per pixel and 8-bit rounding
+
+#include "check.hpp"
+#include "sector_raster.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const int SIZE = 440;
+static const int MAX_CHANNEL_DELTA = 24;
+static const int MAX_CORNER_DELTA = 64;
+
+// Arc flattening of the Cairo reference, in device pixels (Cairo's default: 0.1)
+static const double REFERENCE_TOLERANCE = 0.01;
+
+struct Paint {
+    const char* name;
+    Color fill;
+    Color border;
+};
+
+// What the menu's Cairo path draws (full turns without the radial seam, like the center disc)
+static void cairo_sector(const Cairo::RefPtr<Cairo::Context>& cr, const AnnularSector& s,
+                         const Paint& paint, double border_width) {
+    cr->begin_new_path();
+    if (s.end_angle - s.start_angle >= 2 * M_PI) {
+        cr->arc(s.cx, s.cy, s.outer_radius, 0, 2 * M_PI);
+        cr->close_path();
+        if (s.inner_radius > 0) {
+            cr->begin_new_sub_path();
+            cr->arc_negative(s.cx, s.cy, s.inner_radius, 2 * M_PI, 0);
+            cr->close_path();
+        }
+    } else {
+        cr->arc(s.cx, s.cy, s.outer_radius, s.start_angle, s.end_angle);
+        cr->arc_negative(s.cx, s.cy, s.inner_radius, s.end_angle, s.start_angle);
+        cr->close_path();
+    }
+    paint.fill.set_as_source(cr);
+    cr->fill_preserve();
+    paint.border.set_as_source(cr);
+    cr->set_line_width(border_width);
+    cr->stroke();
+}
+
+// Device pixels near one of the four corners (none for a full ring)
+static bool near_corner(const AnnularSector& s, double scale, double border_width, int x, int y) {
+    if (s.end_angle - s.start_angle >= 2 * M_PI) {
+        return false;
+    }
+    double reach = (border_width + 2) * std::max(scale, 1.0);
+    double center = SIZE / 2.0;
+    for (double radius : {s.inner_radius, s.outer_radius}) {
+        for (double angle : {s.start_angle, s.end_angle}) {
+            double cx = center + (s.cx - center + radius * std::cos(angle)) * scale;
+            double cy = center + (s.cy - center + radius * std::sin(angle)) * scale;
+            if (std::hypot(x + 0.5 - cx, y + 0.5 - cy) <= reach) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static Cairo::RefPtr<Cairo::ImageSurface> render(const AnnularSector& s, const Paint& paint,
+                                                 double border_width, double scale, bool analytic) {
+    auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, SIZE, SIZE);
+    auto cr = Cairo::Context::create(surface);
+
+    // Scaled about the center, as the opening animation does
+    cr->translate(SIZE / 2.0, SIZE / 2.0);
+    cr->scale(scale, scale);
+    cr->translate(-SIZE / 2.0, -SIZE / 2.0);
+
+    if (analytic) {
+        CHECK(paint_sector(cr, s, paint.fill, paint.border, border_width));
+    } else {
+        cr->set_tolerance(REFERENCE_TOLERANCE);
+        cairo_sector(cr, s, paint, border_width);
+    }
+    surface->flush();
+    return surface;
+}
+
+// Largest channel difference, away from the corners and near them
+static void compare(const AnnularSector& s, const Paint& paint, double border_width, double scale) {
+    auto expected = render(s, paint, border_width, scale, false);
+    auto actual = render(s, paint, border_width, scale, true);
+
+    int worst = 0;
+    int worst_corner = 0;
+    for (int y = 0; y < SIZE; ++y) {
+        auto* want = reinterpret_cast<const uint32_t*>(expected->get_data() + y * expected->get_stride());
+        auto* got = reinterpret_cast<const uint32_t*>(actual->get_data() + y * actual->get_stride());
+        for (int x = 0; x < SIZE; ++x) {
+            int delta = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                int a = static_cast<int>((want[x] >> shift) & 0xFF);
+                int b = static_cast<int>((got[x] >> shift) & 0xFF);
+                delta = std::max(delta, std::abs(a - b));
+            }
+            int& bound = near_corner(s, scale, border_width, x, y) ? worst_corner : worst;
+            bound = std::max(bound, delta);
+        }
+    }
+
+    if (worst > MAX_CHANNEL_DELTA || worst_corner > MAX_CORNER_DELTA) {
+        std::fprintf(stderr, "%s r=%g..%g angle=%g+%g scale=%g: delta %d, at corners %d\n",
+                     paint.name, s.inner_radius, s.outer_radius, s.start_angle,
+                     s.end_angle - s.start_angle, scale, worst, worst_corner);
+    }
+    CHECK(worst <= MAX_CHANNEL_DELTA);
+    CHECK(worst_corner <= MAX_CORNER_DELTA);
+}
+
+int main() {
+    Color blue = Color::from_rgb(76, 128, 204);
+    blue.a = 0.9;
+    Color light = Color::from_rgb(230, 230, 230);
+    light.a = 0.9;
+    const Paint paints[] = {
+        {"fill", blue, Color()},
+        {"stroke", Color(), light},
+        {"fill+stroke", blue, light},
+    };
+
+    const double radii[][2] = {{30, 120}, {60, 90}, {40, 200}};
+    const double spans[] = {M_PI / 8, M_PI / 3, M_PI / 2, M_PI};
+    const double starts[] = {-M_PI / 2, 0.3, 2.5};
+    const double c = SIZE / 2.0;
+
+    for (const auto& paint : paints) {
+        for (double scale : {1.0, 0.75}) {
+            for (const auto& radius : radii) {
+                for (double span : spans) {
+                    for (double start : starts) {
+                        compare(AnnularSector{c, c, radius[0], radius[1], start, start + span}, paint, 2, scale);
+                    }
+                }
+                compare(AnnularSector{c, c, radius[0], radius[1], 0, 2 * M_PI}, paint, 2, scale);
+            }
+
+            // Center disc, and a thick border
+            compare(AnnularSector{c, c, 0, 80, 0, 2 * M_PI}, paint, 2, scale);
+            compare(AnnularSector{c, c, 50, 150, 0.3, 0.3 + M_PI / 3}, paint, 6, scale);
+        }
+    }
+
+    // Off-center: the buffer only covers the sector's bounds
+    compare(AnnularSector{c - 37.25, c + 12.5, 30, 120, -M_PI / 2, 0}, paints[2], 2, 1.0);
+
+    // Shapes the rasterizer turns down are left to Cairo
+    auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, SIZE, SIZE);
+    auto cr = Cairo::Context::create(surface);
+    CHECK(!paint_sector(cr, AnnularSector{c, c, 30, 120, 0, 1.5 * M_PI}, blue, light, 2));
+    cr->rotate(0.1);
+    CHECK(!paint_sector(cr, AnnularSector{c, c, 30, 120, 0, M_PI / 4}, blue, light, 2));
+
+    return check_result();
+}
@@ -0,0 +1,69 @@
+// Provider plugin for provider_plugin_test, built once per configuration:
+// TEST_PLUGIN_NAME, TEST_PLUGIN_CACHE and TEST_PLUGIN_ABI pick the name,
+// cache mode and ABI version it declares
+// fetch() does what its argument says; the counters below are read by the
+// test through dlsym()
+
+#include "radux_plugin.h"
+#include <atomic>
+#include <cstring>
+#include <unistd.h>
+
+extern "C" {
+std::atomic<int> radux_test_fetches{0};       // fetch() calls
+std::atomic<int> radux_test_gate{0};          // Set by the test to let "stream" finish
+std::atomic<int> radux_test_cancel_seen{0};   // "wait" saw is_cancelled()
+std::atomic<int> radux_test_emit_refused{0};  // emit() returned 0 after cancelling
+}
+
+static void fetch(void*, const radux_host_api* host, radux_request* request, const char* arg) {
+    ++radux_test_fetches;
+
+    if (std::strcmp(arg, "fields") == 0) {
+        radux_item item = {"Label", "echo hi", "Description", "icon-name", "h", "nested", "nested-arg", 42};
+        host->emit(request, &item);
+        item = {"Bare", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, -3};
+        host->emit(request, &item);
+        item = {nullptr, "ignored", nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+        host->emit(request, &item);
+    } else if (std::strcmp(arg, "stream") == 0) {
+        // The first item must be on screen while this one is still running
+        radux_item first = {"first", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+        host->emit(request, &first);
+        for (int i = 0; i < 5000 && !radux_test_gate && !host->is_cancelled(request); ++i) {
+            usleep(1000);
+        }
+        radux_item second = {"second", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+        host->emit(request, &second);
+    } else if (std::strcmp(arg, "wait") == 0) {
+        // Well behaved: returns once the user has left the level
+        for (int i = 0; i < 5000 && !host->is_cancelled(request); ++i) {
+            usleep(1000);
+        }
+        radux_test_cancel_seen = host->is_cancelled(request);
+        radux_item late = {"late", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+        radux_test_emit_refused = host->emit(request, &late) == 0;
+    } else if (std::strcmp(arg, "stuck") == 0) {
+        // Badly behaved: never looks at cancellation
+        for (;;) {
+            pause();
+        }
+    } else {
+        radux_item item = {arg, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+        host->emit(request, &item);
+    }
+}
+
+static const radux_provider PROVIDER = {
+    TEST_PLUGIN_ABI,
+    TEST_PLUGIN_NAME,
+    TEST_PLUGIN_CACHE,
+    0,
+    nullptr,
+    nullptr,
+    fetch
+};
+
+extern "C" const radux_provider* radux_plugin_entry() {
+    return &PROVIDER;
+}
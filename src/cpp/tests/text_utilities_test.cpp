@@ -0,0 +1,37 @@
+// UTF-8 truncation shared by breadcrumbs, clipboard labels and notifications
+
+#include "check.hpp"
+#include "text_Utilities.hpp"
+#include <string>
+
+int main() {
+    // Short enough: unchanged
+    CHECK(Utf8Text::truncate("abc", 3) == "abc");
+    CHECK(Utf8Text::truncate("", 0) == "");
+
+    // The ellipsis counts toward the limit
+    CHECK(Utf8Text::truncate("abcdef", 5) == "ab...");
+    CHECK(Utf8Text::truncate("abcdef", 4, ".") == "abc.");
+
+    // Narrower than the ellipsis: the limit still holds
+    CHECK(Utf8Text::truncate("abcdef", 3) == "...");
+    CHECK(Utf8Text::truncate("abcdef", 2) == "..");
+    CHECK(Utf8Text::truncate("abcdef", 1) == ".");
+    CHECK(Utf8Text::truncate("abcdef", 0) == "");
+    CHECK(Utf8Text::truncate("abcdef", 1, "\xe2\x80\xa6") == "\xe2\x80\xa6");  // "…"
+    CHECK(Utf8Text::truncate("abcdef", 0, "\xe2\x80\xa6") == "");
+
+    // Multi-byte characters count once and are never split
+    std::string accents = "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9";  // "éééé"
+    CHECK(Utf8Text::length(accents) == 4);
+    CHECK(Utf8Text::truncate(accents, 4, ".") == accents);
+    CHECK(Utf8Text::truncate(accents, 3, ".") == "\xc3\xa9\xc3\xa9.");
+
+    std::string mixed = "a\xe2\x82\xac" "b\xf0\x9f\x98\x80" "c";  // "a€b😀c"
+    CHECK(Utf8Text::length(mixed) == 5);
+    CHECK(Utf8Text::truncate(mixed, 5, ".") == mixed);
+    CHECK(Utf8Text::truncate(mixed, 4, ".") == "a\xe2\x82\xac" "b.");
+    CHECK(Utf8Text::truncate(mixed, 3, ".") == "a\xe2\x82\xac" ".");
+
+    return check_result();
+}
@@ -0,0 +1,195 @@
+// Window table against a real X server (run under xvfb-run)
+// A second X client plays the window manager: it publishes _NET_CLIENT_LIST
+// and _NET_ACTIVE_WINDOW for windows with known WM_CLASS values, and receives
+// the activation requests raise() sends to the root window
+
+#include "check.hpp"
+#include "window_table.hpp"
+#include <gtk/gtk.h>
+#include <gdk/x11/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// The window manager, on its own connection
+struct FakeWindowManager {
+    Display* display = nullptr;
+    Window root = None;
+    Atom net_client_list = None;
+    Atom net_active_window = None;
+
+    bool open() {
+        display = XOpenDisplay(nullptr);
+        if (!display) {
+            return false;
+        }
+        root = DefaultRootWindow(display);
+        net_client_list = XInternAtom(display, "_NET_CLIENT_LIST", False);
+        net_active_window = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
+
+        // Requests sent to the root window with this mask come to us
+        XSelectInput(display, root, SubstructureRedirectMask);
+        XSync(display, False);
+        return true;
+    }
+
+    ~FakeWindowManager() {
+        if (display) {
+            XCloseDisplay(display);
+        }
+    }
+
+    Window create(const char* instance, const char* wm_class) {
+        Window window = XCreateSimpleWindow(display, root, 0, 0, 10, 10, 0, 0, 0);
+        XClassHint hint = {const_cast<char*>(instance), const_cast<char*>(wm_class)};
+        XSetClassHint(display, window, &hint);
+        return window;
+    }
+
+    void set_clients(std::vector<Window> windows) {
+        XChangeProperty(display, root, net_client_list, XA_WINDOW, 32, PropModeReplace,
+                        reinterpret_cast<unsigned char*>(windows.data()), static_cast<int>(windows.size()));
+        XSync(display, False);
+    }
+
+    void set_active(Window window) {
+        XChangeProperty(display, root, net_active_window, XA_WINDOW, 32, PropModeReplace,
+                        reinterpret_cast<unsigned char*>(&window), 1);
+        XSync(display, False);
+    }
+
+    // Window of the next _NET_ACTIVE_WINDOW request, if one has arrived
+    bool take_request(Window& window, long& source) {
+        XEvent event;
+        while (XCheckTypedEvent(display, ClientMessage, &event)) {
+            if (event.xclient.message_type == net_active_window) {
+                window = event.xclient.window;
+                source = event.xclient.data.l[0];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void discard_requests() {
+        Window window = None;
+        long source = 0;
+        while (take_request(window, source)) {
+        }
+    }
+};
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        usleep(1000);
+    }
+    return true;
+}
+
+// Run the main loop a little longer (for changes that show no other way)
+static void settle() {
+    pump_until([start = std::chrono::steady_clock::now()]() {
+        return std::chrono::steady_clock::now() - start > std::chrono::milliseconds(300);
+    });
+}
+
+// Window the manager is asked to activate for wm_class (None if raise() refused)
+static Window raised(FakeWindowManager& wm, const std::string& wm_class) {
+    if (!WindowTable::instance().raise(wm_class)) {
+        return None;
+    }
+    Window window = None;
+    long source = 0;
+    if (!pump_until([&]() { return wm.take_request(window, source); })) {
+        return None;
+    }
+    CHECK(source == 2);  // Direct user action
+    return window;
+}
+
+int main() {
+    gtk_init();
+    GdkDisplay* gdk_display = gdk_display_get_default();
+    if (!gdk_display || !GDK_IS_X11_DISPLAY(gdk_display)) {
+        std::cerr << "No X11 display, skipping\n";
+        return SKIPPED;
+    }
+
+    FakeWindowManager wm;
+    if (!wm.open()) {
+        return SKIPPED;
+    }
+    Window term = wm.create("xterm", "XTerm");
+    Window other_term = wm.create("xterm", "XTerm");
+    Window browser = wm.create("Navigator", "firefox");
+    wm.set_clients({term, browser});
+
+    // The list present at start is read at once
+    auto& table = WindowTable::instance();
+    CHECK(table.start());
+    CHECK(raised(wm, "XTerm") == term);
+
+    // Class or instance, in any case
+    CHECK(raised(wm, "xterm") == term);
+    CHECK(raised(wm, "FIREFOX") == browser);
+    CHECK(raised(wm, "navigator") == browser);
+
+    // Nothing matches: no request
+    CHECK(!table.raise("gimp"));
+    CHECK(!table.raise(""));
+
+    // A window without WM_CLASS, and one gone before its class is read, match
+    // nothing and cost no X error
+    Window bare = XCreateSimpleWindow(wm.display, wm.root, 0, 0, 10, 10, 0, 0, 0);
+    Window gone = wm.create("gone", "Gone");
+    XDestroyWindow(wm.display, gone);
+    wm.set_clients({term, browser, bare, gone});
+    wm.set_active(bare);
+    settle();
+    CHECK(!table.raise("gone"));
+    CHECK(raised(wm, "firefox") == browser);
+    wm.set_clients({term, browser});
+
+    // Windows that appear later are followed
+    wm.set_clients({term, browser, other_term});
+    wm.set_active(other_term);
+    CHECK(pump_until([&]() { return raised(wm, "xterm") == other_term; }));
+
+    // The most recently active match wins
+    wm.set_active(browser);
+    wm.set_active(term);
+    CHECK(pump_until([&]() { return raised(wm, "xterm") == term; }));
+    wm.set_active(other_term);
+    CHECK(pump_until([&]() { return raised(wm, "xterm") == other_term; }));
+
+    // Closed windows are forgotten, however recently active
+    wm.set_clients({term, browser});
+    CHECK(pump_until([&]() { return raised(wm, "xterm") == term; }));
+    wm.set_clients({browser});
+    CHECK(pump_until([&]() { return !table.raise("xterm"); }));
+    XSync(wm.display, False);
+    wm.discard_requests();
+    CHECK(raised(wm, "firefox") == browser);
+
+    // A refused raise sent nothing
+    Window window = None;
+    long source = 0;
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    XSync(wm.display, False);
+    CHECK(!wm.take_request(window, source));
+
+    return check_result();
+}
@@ -0,0 +1,81 @@
+// Worker jobs awaited from main-loop tasks: results, exceptions, cancellation
+
+#include "check.hpp"
+#include "main_loop_task.hpp"
+#include <glibmm/init.h>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+struct Outcome {
+    bool finished = false;  // The task ran to its end
+    int value = 0;
+    std::string error;
+};
+
+static Task add_one(CancelToken token, Outcome* outcome) {
+    outcome->value = co_await run_in_worker(token, []() { return 41; }) + 1;
+    outcome->finished = true;
+}
+
+static Task fail(CancelToken token, Outcome* outcome) {
+    try {
+        outcome->value = co_await run_in_worker(token, []() -> int { throw std::runtime_error("job failed"); });
+    } catch (const std::runtime_error& e) {
+        outcome->error = e.what();
+    }
+    outcome->finished = true;
+}
+
+static Task slow(CancelToken token, Outcome* outcome) {
+    outcome->value = co_await run_in_worker(token, []() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return 1;
+    });
+    outcome->finished = true;
+}
+
+// Run the main loop until done() holds (false after a few seconds)
+static bool pump_until(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        g_main_context_iteration(nullptr, FALSE);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+int main() {
+    Glib::init();
+    CancelScope scope;
+
+    // The result comes back on the main loop
+    Outcome sum;
+    add_one(scope.token(), &sum);
+    CHECK(!sum.finished);
+    CHECK(pump_until([&]() { return sum.finished; }));
+    CHECK(sum.value == 42);
+
+    // A throwing job resumes the task with its exception instead of leaving it suspended
+    Outcome failed;
+    fail(scope.token(), &failed);
+    CHECK(pump_until([&]() { return failed.finished; }));
+    CHECK(failed.error == "job failed");
+    CHECK(failed.value == 0);
+
+    // A cancelled task is dropped; the job's late result goes nowhere
+    CancelScope short_lived;
+    Outcome cancelled;
+    slow(short_lived.token(), &cancelled);
+    short_lived.cancel();
+    auto settle = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    pump_until([&]() { return std::chrono::steady_clock::now() > settle; });
+    CHECK(!cancelled.finished);
+
+    return check_result();
+}
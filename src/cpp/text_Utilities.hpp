@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+
+// UTF-8 helpers for text shown in labels, previews and notifications
+class Utf8Text {
+public:
+    // Code points in text (continuation bytes are not counted)
+    static size_t length(const std::string& text) {
+        size_t chars = 0;
+        for (char c : text) {
+            if (!is_continuation(c)) {
+                ++chars;
+            }
+        }
+        return chars;
+    }
+
+    // Shorten text to at most max_chars code points, ellipsis included
+    // Cuts only between code points, so a multi-byte character is never split
+    // Below the ellipsis' own length, only as much of the ellipsis as fits is left
+    static std::string truncate(const std::string& text, size_t max_chars,
+                                const std::string& ellipsis = "...") {
+        if (length(text) <= max_chars) {
+            return text;
+        }
+
+        size_t ellipsis_chars = length(ellipsis);
+        if (max_chars <= ellipsis_chars) {
+            return prefix(ellipsis, max_chars);
+        }
+        return prefix(text, max_chars - ellipsis_chars) + ellipsis;
+    }
+
+private:
+    // The first chars code points of text
+    static std::string prefix(const std::string& text, size_t chars) {
+        size_t seen = 0;
+        size_t end = 0;
+        for (; end < text.size(); ++end) {
+            if (!is_continuation(text[end]) && seen++ == chars) {
+                break;
+            }
+        }
+        return text.substr(0, end);
+    }
+
+    static bool is_continuation(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+};
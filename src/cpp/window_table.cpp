@@ -0,0 +1,236 @@
+#include "window_table.hpp"
+#include <gtk/gtk.h>
+#include <gdk/gdk.h>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <strings.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(HAS_X11) && defined(GDK_WINDOWING_X11)
+#define WINDOW_TABLE_X11 1
+#include <gdk/x11/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+#endif
+
+#ifdef WINDOW_TABLE_X11
+
+// _NET_CLIENT_LIST entries read at most
+static const long MAX_CLIENTS = 4096;
+
+// WM_CLASS bytes read per window (instance and class, each NUL-terminated)
+static const uint32_t MAX_CLASS_LENGTH = 1024;
+
+struct WindowTableX11 {
+    struct Client {
+        std::string instance;
+        std::string wm_class;
+        uint64_t last_active = 0;  // Activation order (0: not seen active)
+    };
+
+    GdkDisplay* gdk_display = nullptr;
+    Display* display = nullptr;
+    Window root = None;
+    Atom net_client_list = None;
+    Atom net_active_window = None;
+
+    std::unordered_map<Window, Client> clients;
+    uint64_t activations = 0;
+
+    void read_client_list();
+    void read_active_window();
+};
+
+void WindowTableX11::read_client_list() {
+    Atom type = None;
+    int format = 0;
+    unsigned long count = 0;
+    unsigned long remaining = 0;
+    unsigned char* value = nullptr;
+    if (XGetWindowProperty(display, root, net_client_list, 0, MAX_CLIENTS, False, XA_WINDOW,
+                           &type, &format, &count, &remaining, &value) != Success) {
+        return;
+    }
+
+    std::unordered_set<Window> listed;
+    if (type == XA_WINDOW && format == 32) {
+        auto* windows = reinterpret_cast<Window*>(value);
+        listed.insert(windows, windows + count);
+    }
+    if (value) {
+        XFree(value);
+    }
+
+    for (auto it = clients.begin(); it != clients.end();) {
+        it = listed.count(it->first) ? std::next(it) : clients.erase(it);
+    }
+
+    // Only new windows cost a request, and all of them are sent before any
+    // reply is read: one round trip however many windows a one-shot instance
+    // finds. A window may be gone by then; its error comes back as the reply
+    xcb_connection_t* conn = XGetXCBConnection(display);
+    std::vector<std::pair<Window, xcb_get_property_cookie_t>> lookups;
+    for (Window window : listed) {
+        if (!clients.count(window)) {
+            lookups.emplace_back(window, xcb_get_property(conn, 0, static_cast<xcb_window_t>(window),
+                                                          XCB_ATOM_WM_CLASS, XCB_ATOM_STRING,
+                                                          0, MAX_CLASS_LENGTH / 4));
+        }
+    }
+
+    for (const auto& [window, cookie] : lookups) {
+        Client client;
+        xcb_generic_error_t* error = nullptr;
+        xcb_get_property_reply_t* reply = xcb_get_property_reply(conn, cookie, &error);
+        if (reply && reply->format == 8) {
+            // "instance\0class\0"
+            const char* value = static_cast<const char*>(xcb_get_property_value(reply));
+            std::string both(value, static_cast<size_t>(xcb_get_property_value_length(reply)));
+            size_t end = both.find('\0');
+            client.instance = both.substr(0, end);
+            if (end != std::string::npos) {
+                client.wm_class = both.substr(end + 1, both.find('\0', end + 1) - end - 1);
+            }
+        }
+        free(reply);
+        free(error);
+        clients.emplace(window, std::move(client));
+    }
+}
+
+void WindowTableX11::read_active_window() {
+    Atom type = None;
+    int format = 0;
+    unsigned long count = 0;
+    unsigned long remaining = 0;
+    unsigned char* value = nullptr;
+    if (XGetWindowProperty(display, root, net_active_window, 0, 1, False, XA_WINDOW,
+                           &type, &format, &count, &remaining, &value) != Success) {
+        return;
+    }
+
+    if (type == XA_WINDOW && format == 32 && count == 1) {
+        auto found = clients.find(*reinterpret_cast<Window*>(value));
+        if (found != clients.end()) {
+            found->second.last_active = ++activations;
+        }
+    }
+    if (value) {
+        XFree(value);
+    }
+}
+
+// Every event on GDK's connection passes through here before GDK sees it
+static gboolean on_xevent(GdkX11Display*, XEvent* event, gpointer data) {
+    auto* x11 = static_cast<WindowTableX11*>(data);
+
+    if (event->type == PropertyNotify && event->xproperty.window == x11->root) {
+        if (event->xproperty.atom == x11->net_client_list) {
+            x11->read_client_list();
+        } else if (event->xproperty.atom == x11->net_active_window) {
+            x11->read_active_window();
+        }
+    }
+
+    // GDK follows root properties too
+    return FALSE;
+}
+
+#else
+
+struct WindowTableX11 {};
+
+#endif
+
+WindowTable::WindowTable() = default;
+
+// Lives until exit, when GDK's display may already be gone: nothing to undo
+WindowTable::~WindowTable() = default;
+
+bool WindowTable::start() {
+#ifdef WINDOW_TABLE_X11
+    if (x11_) {
+        return true;
+    }
+    if (failed_) {
+        return false;
+    }
+
+    GdkDisplay* gdk_display = gdk_display_get_default();
+    if (!gdk_display || !GDK_IS_X11_DISPLAY(gdk_display)) {
+        failed_ = true;
+        return false;
+    }
+
+    auto x11 = std::make_unique<WindowTableX11>();
+    x11->gdk_display = gdk_display;
+    x11->display = gdk_x11_display_get_xdisplay(gdk_display);
+    x11->root = DefaultRootWindow(x11->display);
+    x11->net_client_list = XInternAtom(x11->display, "_NET_CLIENT_LIST", False);
+    x11->net_active_window = XInternAtom(x11->display, "_NET_ACTIVE_WINDOW", False);
+
+    // Added to GDK's own mask on the root window; selecting first means no change is missed
+    XWindowAttributes attributes;
+    if (!XGetWindowAttributes(x11->display, x11->root, &attributes)) {
+        failed_ = true;
+        return false;
+    }
+    XSelectInput(x11->display, x11->root, attributes.your_event_mask | PropertyChangeMask);
+
+    x11->read_client_list();
+    x11->read_active_window();
+
+    x11_ = std::move(x11);
+    g_signal_connect(gdk_display, "xevent", G_CALLBACK(on_xevent), x11_.get());
+    return true;
+#else
+    failed_ = true;
+    return false;
+#endif
+}
+
+bool WindowTable::raise(const std::string& wm_class) {
+    if (!start()) {
+        std::cerr << "Raise: No window list (needs X11), starting instead\n";
+        return false;
+    }
+
+#ifdef WINDOW_TABLE_X11
+    Window match = None;
+    uint64_t match_active = 0;
+    for (const auto& [window, client] : x11_->clients) {
+        bool matches = strcasecmp(client.wm_class.c_str(), wm_class.c_str()) == 0 ||
+                       strcasecmp(client.instance.c_str(), wm_class.c_str()) == 0;
+        if (matches && (match == None || client.last_active > match_active)) {
+            match = window;
+            match_active = client.last_active;
+        }
+    }
+    if (match == None) {
+        return false;
+    }
+
+    // EWMH activation request; the window manager switches desktop and unminimizes as needed
+    XEvent event = {};
+    event.xclient.type = ClientMessage;
+    event.xclient.window = match;
+    event.xclient.message_type = x11_->net_active_window;
+    event.xclient.format = 32;
+    event.xclient.data.l[0] = 2;  // Source: pager (direct user action)
+    event.xclient.data.l[1] = static_cast<long>(gdk_x11_display_get_user_time(x11_->gdk_display));
+    event.xclient.data.l[2] = None;
+    XSendEvent(x11_->display, x11_->root, False, SubstructureRedirectMask | SubstructureNotifyMask, &event);
+    XFlush(x11_->display);
+    return true;
+#else
+    (void)wm_class;
+    return false;
+#endif
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <memory>
+
+// Top-level windows by WM_CLASS, for "raise-class" items
+// The list follows _NET_CLIENT_LIST through PropertyNotify events on GDK's
+// own X11 connection: only windows that appear are queried for their class
+// (all in one round trip), so raising an existing window is one
+// _NET_ACTIVE_WINDOW message instead of an xdotool search. The resident
+// (--daemon) instance keeps it warm; a one-shot instance reads the list on
+// first use
+class WindowTable {
+public:
+    static WindowTable& instance() {
+        static WindowTable inst;
+        return inst;
+    }
+
+    // Prevent copying
+    WindowTable(const WindowTable&) = delete;
+    WindowTable& operator=(const WindowTable&) = delete;
+
+    // GTK thread: read the window list and follow its changes (X11 only)
+    bool start();
+
+    // GTK thread: activate the most recently used window whose WM_CLASS class
+    // or instance matches (case-insensitive); false if there is none
+    bool raise(const std::string& wm_class);
+
+private:
+    WindowTable();
+    ~WindowTable();
+
+    bool failed_ = false;
+
+    // X11 connection state (defined in the .cpp, empty without X11)
+    std::unique_ptr<struct WindowTableX11> x11_;
+};
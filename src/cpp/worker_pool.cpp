@@ -0,0 +1,81 @@
+#include "worker_pool.hpp"
+#include <glibmm/main.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// How long exit waits for jobs that are still running
+static const int SHUTDOWN_WAIT_MS = 500;
+
+WorkerPool::WorkerPool() {
+    // A few threads are plenty: jobs are I/O bound (directory reads, file parsing, plugins)
+    unsigned int count = std::clamp(std::thread::hardware_concurrency(), 2u, 4u);
+    queue_->running = count;
+    for (unsigned int i = 0; i < count; ++i) {
+        threads_.emplace_back(&WorkerPool::worker_loop, queue_);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    bool finished;
+    {
+        std::unique_lock<std::mutex> lock(queue_->mutex);
+        queue_->stopping = true;
+        queue_->jobs.clear();
+        queue_->cv.notify_all();
+        finished = queue_->cv.wait_for(lock, std::chrono::milliseconds(SHUTDOWN_WAIT_MS),
+                                       [this]() { return queue_->running == 0; });
+    }
+
+    // A thread stuck in a job keeps its share of the queue and ends with the process
+    if (!finished) {
+        std::cerr << "WorkerPool: Jobs still running at exit, not waiting for them\n";
+    }
+    for (auto& thread : threads_) {
+        if (finished) {
+            thread.join();
+        } else {
+            thread.detach();
+        }
+    }
+}
+
+void WorkerPool::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(queue_->mutex);
+        queue_->jobs.push_back(std::move(job));
+    }
+    queue_->cv.notify_one();
+}
+
+void WorkerPool::run_on_main(Job job) {
+    Glib::MainContext::get_default()->invoke([job = std::move(job)]() {
+        job();
+        return false;  // One-shot
+    });
+}
+
+void WorkerPool::worker_loop(std::shared_ptr<Queue> queue) {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->cv.wait(lock, [&queue]() { return queue->stopping || !queue->jobs.empty(); });
+            if (queue->stopping) {
+                --queue->running;
+                queue->cv.notify_all();
+                return;
+            }
+            job = std::move(queue->jobs.front());
+            queue->jobs.pop_front();
+        }
+
+        try {
+            job();
+        } catch (const std::exception& e) {
+            std::cerr << "WorkerPool: Job failed: " << e.what() << "\n";
+        } catch (...) {
+            std::cerr << "WorkerPool: Job failed\n";
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Fixed-size pool of background threads for work that must not block the UI
+// Results go back to the GTK thread through run_on_main()
+// At exit, queued jobs are dropped and running ones get a moment to finish;
+// threads still stuck in a job (a hung plugin, a slow mount) are left behind
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    static WorkerPool& instance() {
+        static WorkerPool inst;
+        return inst;
+    }
+
+    // Prevent copying
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Queue a job for a worker thread
+    void submit(Job job);
+
+    // Run a function on the GTK main loop (callable from any thread)
+    static void run_on_main(Job job);
+
+    size_t thread_count() const { return threads_.size(); }
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+
+    // Owned jointly with the threads, so one left running never outlives it
+    struct Queue {
+        std::deque<Job> jobs;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+        unsigned running = 0;  // Threads that have not returned yet
+    };
+
+    static void worker_loop(std::shared_ptr<Queue> queue);
+
+    std::vector<std::thread> threads_;
+    std::shared_ptr<Queue> queue_ = std::make_shared<Queue>();
+};